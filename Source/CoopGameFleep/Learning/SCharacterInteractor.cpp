@@ -7,6 +7,44 @@
 #include "STargetActor.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "SCharacter.h"
+#include "SCharacterManagerComponent.h"
+#include "Learning/SCharacterTrainingStats.h"
+#include "Learning/SObstacleManager.h"
+#include "Async/ParallelFor.h"
+
+namespace SCharacterInteractorLayout
+{
+	// Element names in schema order, resolved once instead of hashing string literals every step
+	static const FName ObservationNames[ObservationElementNum] =
+	{
+		TEXT("CharacterLocation"),
+		TEXT("CharacterVelocity"),
+		TEXT("CharacterDirection"),
+		TEXT("TargetLocation"),
+		TEXT("DirectionToTarget"),
+		TEXT("DistanceToTarget"),
+		TEXT("FacingAlignment"),
+		TEXT("ObstacleRays"),
+		TEXT("OccupancyGrid"),
+		TEXT("ObservationHistory")
+	};
+
+	static const FName ActionNames[ActionElementNum] =
+	{
+		TEXT("MoveForward"),
+		TEXT("MoveRight"),
+		TEXT("Turn")
+	};
+
+	static const FName LocationTag = TEXT("LocationObservation");
+	static const FName VelocityTag = TEXT("VelocityObservation");
+	static const FName DirectionTag = TEXT("DirectionObservation");
+	static const FName FloatObservationTag = TEXT("FloatObservation");
+	static const FName ContinuousObservationTag = TEXT("ContinuousObservation");
+	static const FName StructObservationTag = TEXT("StructObservation");
+	static const FName FloatActionTag = TEXT("FloatAction");
+	static const FName StructActionTag = TEXT("StructAction");
+}
 
 USCharacterInteractor::USCharacterInteractor()
 {
@@ -17,128 +55,594 @@ void USCharacterInteractor::SpecifyAgentObservation_Implementation(
 	FLearningAgentsObservationSchemaElement& OutObservationSchemaElement,
 	ULearningAgentsObservationSchema* InObservationSchema)
 {
-	// Define observations for the character learning task
-	TMap<FName, FLearningAgentsObservationSchemaElement> CharacterObservations;
+	using namespace SCharacterInteractorLayout;
+
+	// Define observations for the character learning task, one slot per layout entry
+	FLearningAgentsObservationSchemaElement CharacterObservations[ObservationElementNum];
 
 	// Character position relative to world
-	CharacterObservations.Add("CharacterLocation", 
-		ULearningAgentsObservations::SpecifyLocationObservation(
-			InObservationSchema, MaxObservationDistance, "LocationObservation"));
+	CharacterObservations[CharacterLocation] =
+		ULearningAgentsObservations::SpecifyLocationObservation(InObservationSchema, MaxObservationDistance, LocationTag);
 
 	// Character velocity
-	CharacterObservations.Add("CharacterVelocity", 
-		ULearningAgentsObservations::SpecifyVelocityObservation(InObservationSchema, MaxVelocity));
+	CharacterObservations[CharacterVelocity] =
+		ULearningAgentsObservations::SpecifyVelocityObservation(InObservationSchema, MaxVelocity, VelocityTag);
 
 	// Character forward direction
-	CharacterObservations.Add("CharacterDirection", 
-		ULearningAgentsObservations::SpecifyDirectionObservation(InObservationSchema, "DirectionObservation"));
+	CharacterObservations[CharacterDirection] =
+		ULearningAgentsObservations::SpecifyDirectionObservation(InObservationSchema, DirectionTag);
 
 	// Target position relative to world
-	CharacterObservations.Add("TargetLocation", 
-		ULearningAgentsObservations::SpecifyLocationObservation(
-			InObservationSchema, MaxObservationDistance, "LocationObservation"));
+	CharacterObservations[TargetLocation] =
+		ULearningAgentsObservations::SpecifyLocationObservation(InObservationSchema, MaxObservationDistance, LocationTag);
 
 	// Direction from character to target
-	CharacterObservations.Add("DirectionToTarget", 
-		ULearningAgentsObservations::SpecifyDirectionObservation(InObservationSchema, "DirectionObservation"));
+	CharacterObservations[DirectionToTarget] =
+		ULearningAgentsObservations::SpecifyDirectionObservation(InObservationSchema, DirectionTag);
 
 	// Distance to target (normalized)
-	CharacterObservations.Add("DistanceToTarget", 
-		ULearningAgentsObservations::SpecifyFloatObservation(InObservationSchema, MaxObservationDistance));
+	CharacterObservations[DistanceToTarget] =
+		ULearningAgentsObservations::SpecifyFloatObservation(InObservationSchema, MaxObservationDistance, FloatObservationTag);
 
 	// Facing alignment to target (-1 to 1, where 1 means perfectly facing target)
-	CharacterObservations.Add("FacingAlignment", 
-		ULearningAgentsObservations::SpecifyFloatObservation(InObservationSchema, 1.0f));
+	CharacterObservations[FacingAlignment] =
+		ULearningAgentsObservations::SpecifyFloatObservation(InObservationSchema, 1.0f, FloatObservationTag);
+
+	SpecifyObservationLayout(Manager ? Manager->GetMaxAgentNum() : 0);
+
+	// Optional elements are appended after the fixed ones so disabling them keeps the original schema
+	ObservationElementNames.Reset();
+	ObservationElementNames.Append(ObservationNames, FixedObservationElementNum);
+	ObstacleRaySlot = INDEX_NONE;
+	OccupancyGridSlot = INDEX_NONE;
+	ObservationHistorySlot = INDEX_NONE;
+
+	// Normalized distance to the nearest obstacle along each ray of the fan, one fixed-size vector
+	if (SpecifiedObstacleRayNum > 0)
+	{
+		ObstacleRaySlot = ObservationElementNames.Add(ObservationNames[ObstacleRays]);
+		CharacterObservations[ObstacleRaySlot] =
+			ULearningAgentsObservations::SpecifyContinuousObservation(InObservationSchema, SpecifiedObstacleRayNum, 1.0f, ContinuousObservationTag);
+	}
+
+	// Obstacle occupancy around the agent in its own frame, flattened into one fixed-size vector
+	if (SpecifiedOccupancyGridSize > 0)
+	{
+		OccupancyGridSlot = ObservationElementNames.Add(ObservationNames[OccupancyGrid]);
+		CharacterObservations[OccupancyGridSlot] =
+			ULearningAgentsObservations::SpecifyContinuousObservation(InObservationSchema, OccupancyCellCenters.Num(), 1.0f, ContinuousObservationTag);
+	}
+
+	// Previous frames of the fixed elements, rays and occupancy cells, stacked newest first into one fixed-size vector
+	if (SpecifiedHistoryLength > 0)
+	{
+		ObservationHistorySlot = ObservationElementNames.Add(ObservationNames[ObservationHistory]);
+		CharacterObservations[ObservationHistorySlot] =
+			ULearningAgentsObservations::SpecifyContinuousObservation(InObservationSchema, SpecifiedHistoryLength * HistoryFrameSize, 1.0f, ContinuousObservationTag);
+	}
 
 	// Set the complete observation schema
-	OutObservationSchemaElement = ULearningAgentsObservations::SpecifyStructObservation(InObservationSchema, CharacterObservations);
+	OutObservationSchemaElement = ULearningAgentsObservations::SpecifyStructObservationFromArrayViews(InObservationSchema,
+		ObservationElementNames, MakeArrayView(CharacterObservations, ObservationElementNames.Num()), StructObservationTag);
 }
 
-void USCharacterInteractor::GatherAgentObservation_Implementation(
-	FLearningAgentsObservationObjectElement& OutObservationObjectElement,
-	ULearningAgentsObservationObject* InObservationObject, const int32 AgentId)
+void USCharacterInteractor::SpecifyObservationLayout(const int32 MaxAgentNum)
 {
-	// Get the character agent
-	const ASCharacter* Character = Cast<ASCharacter>(Manager->GetAgent(AgentId, ASCharacter::StaticClass()));
-	
-	if (!Character || !TargetActor)
+	using namespace SCharacterInteractorLayout;
+
+	// Ray fan in the agent's frame, centered on its facing
+	SpecifiedObstacleRayNum = ObstacleRayNum;
+	ObstacleRayDirections.Reset(SpecifiedObstacleRayNum);
+	for (int32 Ray = 0; Ray < SpecifiedObstacleRayNum; Ray++)
 	{
-		if (!Character)
+		const float Angle = FMath::DegreesToRadians(ObstacleRayFanAngle * ((Ray + 0.5f) / SpecifiedObstacleRayNum - 0.5f));
+		ObstacleRayDirections.Add(FVector2f(FMath::Cos(Angle), FMath::Sin(Angle)));
+	}
+
+	// Occupancy cell centers in the agent's frame, row-major
+	SpecifiedOccupancyGridSize = OccupancyGridSize;
+	OccupancyCellCenters.Reset(SpecifiedOccupancyGridSize * SpecifiedOccupancyGridSize);
+	for (int32 Row = 0; Row < SpecifiedOccupancyGridSize; Row++)
+	{
+		for (int32 Column = 0; Column < SpecifiedOccupancyGridSize; Column++)
 		{
-			UE_LOG(LogTemp, Error, TEXT("SCharacterInteractor: Failed to get character for agent %d"), AgentId);
+			OccupancyCellCenters.Add(FVector2f(
+				(Row + 0.5f - SpecifiedOccupancyGridSize * 0.5f) * OccupancyCellSize,
+				(Column + 0.5f - SpecifiedOccupancyGridSize * 0.5f) * OccupancyCellSize));
 		}
-		if (!TargetActor)
+	}
+
+	// One history frame holds the fixed elements, rays and occupancy cells
+	SpecifiedHistoryLength = ObservationHistoryLength;
+	HistoryFrameSize = HistoryFixedFrameSize + SpecifiedObstacleRayNum + OccupancyCellCenters.Num();
+
+	ReserveScratchBuffers(MaxAgentNum);
+}
+
+void FSCharacterObservationBatch::SetNum(const int32 Num)
+{
+	Locations.SetNumUninitialized(Num, EAllowShrinking::No);
+	Velocities.SetNumUninitialized(Num, EAllowShrinking::No);
+	Forwards.SetNumUninitialized(Num, EAllowShrinking::No);
+	TargetLocations.SetNumUninitialized(Num, EAllowShrinking::No);
+	DirectionsToTarget.SetNumUninitialized(Num, EAllowShrinking::No);
+	DistancesToTarget.SetNumUninitialized(Num, EAllowShrinking::No);
+	FacingAlignments.SetNumUninitialized(Num, EAllowShrinking::No);
+	ObstacleManagers.SetNumUninitialized(Num, EAllowShrinking::No);
+	bValid.SetNumUninitialized(Num, EAllowShrinking::No);
+}
+
+void FSCharacterObservationBatch::Reserve(const int32 Num)
+{
+	Locations.Reserve(Num);
+	Velocities.Reserve(Num);
+	Forwards.Reserve(Num);
+	TargetLocations.Reserve(Num);
+	DirectionsToTarget.Reserve(Num);
+	DistancesToTarget.Reserve(Num);
+	FacingAlignments.Reserve(Num);
+	ObstacleManagers.Reserve(Num);
+	bValid.Reserve(Num);
+}
+
+SIZE_T FSCharacterObservationBatch::GetAllocatedSize() const
+{
+	return Locations.GetAllocatedSize() + Velocities.GetAllocatedSize() + Forwards.GetAllocatedSize() +
+		TargetLocations.GetAllocatedSize() + DirectionsToTarget.GetAllocatedSize() + DistancesToTarget.GetAllocatedSize() +
+		FacingAlignments.GetAllocatedSize() + ObstacleManagers.GetAllocatedSize() + bValid.GetAllocatedSize() +
+		ObstacleRayDistances.GetAllocatedSize() + WorldRayDirections.GetAllocatedSize() +
+		OccupancyGrids.GetAllocatedSize() + WorldCellCenters.GetAllocatedSize() + CellBlocked.GetAllocatedSize() +
+		StackedHistories.GetAllocatedSize();
+}
+
+void USCharacterInteractor::ReserveScratchBuffers(const int32 MaxAgentNum)
+{
+	// Size our own scratch for the manager's capacity up front so the per-step path never grows it
+	ObservationBatch.Reserve(MaxAgentNum);
+	ObservationBatch.ObstacleRayDistances.Reserve(MaxAgentNum * SpecifiedObstacleRayNum);
+	ObservationBatch.WorldRayDirections.Reserve(MaxAgentNum * SpecifiedObstacleRayNum);
+	ObservationBatch.OccupancyGrids.Reserve(MaxAgentNum * OccupancyCellCenters.Num());
+	ObservationBatch.WorldCellCenters.Reserve(MaxAgentNum * OccupancyCellCenters.Num());
+	ObservationBatch.CellBlocked.Reserve(MaxAgentNum * OccupancyCellCenters.Num());
+	ObservationBatch.StackedHistories.Reserve(MaxAgentNum * SpecifiedHistoryLength * HistoryFrameSize);
+	HistoryFrames.Init(0.0f, SpecifiedHistoryLength > 0 ? MaxAgentNum * (SpecifiedHistoryLength + 1) * HistoryFrameSize : 0);
+	HistoryHeads.Init(0, MaxAgentNum);
+	bHistoryFilled.Init(false, MaxAgentNum);
+	HeldActions.Init(FVector3f::ZeroVector, MaxAgentNum);
+	SingleActionObjectElements.Reset(1);
+	SingleAgentIds.Reset(1);
+	ScratchAllocatedSize = GetScratchAllocatedSize();
+}
+
+SIZE_T USCharacterInteractor::GetScratchAllocatedSize() const
+{
+	return ObservationBatch.GetAllocatedSize() + HistoryFrames.GetAllocatedSize() + HistoryHeads.GetAllocatedSize() +
+		bHistoryFilled.GetAllocatedSize() + HeldActions.GetAllocatedSize() +
+		SingleActionObjectElements.GetAllocatedSize() + SingleAgentIds.GetAllocatedSize();
+}
+
+void USCharacterInteractor::TrackScratchBufferGrowth()
+{
+	const SIZE_T AllocatedSize = GetScratchAllocatedSize();
+	if (AllocatedSize != ScratchAllocatedSize)
+	{
+		ScratchBufferGrowthCount++;
+		ScratchAllocatedSize = AllocatedSize;
+		UE_LOG(LogTemp, Warning, TEXT("SCharacterInteractor: Scratch buffers grew on the step path (%d time(s), now %llu bytes)"),
+			ScratchBufferGrowthCount, (uint64)AllocatedSize);
+	}
+}
+
+void USCharacterInteractor::GatherObservationSnapshot(const TArray<int32>& AgentIds)
+{
+	const int32 AgentNum = AgentIds.Num();
+	ObservationBatch.SetNum(AgentNum);
+
+	const FVector TargetLocation = TargetActor ? TargetActor->GetActorLocation() : FVector::ZeroVector;
+	const USCharacterManagerComponent* ArenaManager = Cast<USCharacterManagerComponent>(Manager);
+
+	// Point-mass agents have no pawn state worth reading, the simulator holds all of it
+	if (const FSCharacterPointMassSim* Sim = ArenaManager ? ArenaManager->GetPointMassSim() : nullptr)
+	{
+		for (int32 Index = 0; Index < AgentNum; Index++)
 		{
-			UE_LOG(LogTemp, Error, TEXT("SCharacterInteractor: TargetActor is NULL - make sure SCharacterManager.TargetActor is set!"));
+			const int32 AgentId = AgentIds[Index];
+			ObservationBatch.Locations[Index] = Sim->GetLocation(AgentId);
+			ObservationBatch.Forwards[Index] = Sim->GetForward(AgentId);
+			ObservationBatch.Velocities[Index] = Sim->GetVelocity(AgentId);
+			ObservationBatch.TargetLocations[Index] = Sim->GetTargetLocation(AgentId);
+			ObservationBatch.ObstacleManagers[Index] = nullptr;
+			ObservationBatch.bValid[Index] = true;
 		}
 		return;
 	}
 
-	// Gather character observations
-	TMap<FName, FLearningAgentsObservationObjectElement> CharacterObservationObject;
+	for (int32 Index = 0; Index < AgentNum; Index++)
+	{
+		// Tiled agents each chase their own target, otherwise everyone chases the shared one
+		const ASTargetActor* ArenaTarget = ArenaManager ? ArenaManager->GetAgentTarget(AgentIds[Index]) : nullptr;
 
-	// Character location
-	CharacterObservationObject.Add("CharacterLocation", 
-		ULearningAgentsObservations::MakeLocationObservation(InObservationObject, Character->GetActorLocation()));
+		const ASCharacter* Character = Cast<ASCharacter>(Manager->GetAgent(AgentIds[Index], ASCharacter::StaticClass()));
+		if (!Character)
+		{
+			UE_LOG(LogTemp, Error, TEXT("SCharacterInteractor: Failed to get character for agent %d"), AgentIds[Index]);
+			ObservationBatch.bValid[Index] = false;
+			continue;
+		}
 
-	// Character velocity
-	FVector CharacterVelocity = FVector::ZeroVector;
-	if (const UCharacterMovementComponent* MovementComp = Character->GetCharacterMovement())
+		const UCharacterMovementComponent* MovementComp = Character->GetCharacterMovement();
+		const FTransform& Transform = Character->GetActorTransform();
+
+		ObservationBatch.Locations[Index] = Transform.GetLocation();
+		ObservationBatch.Forwards[Index] = Transform.GetUnitAxis(EAxis::X);
+		ObservationBatch.Velocities[Index] = MovementComp ? MovementComp->Velocity : FVector::ZeroVector;
+		ObservationBatch.TargetLocations[Index] = ArenaTarget ? ArenaTarget->GetActorLocation() : TargetLocation;
+		ObservationBatch.ObstacleManagers[Index] = ArenaManager ? ArenaManager->GetAgentObstacleManager(AgentIds[Index]) : nullptr;
+		ObservationBatch.bValid[Index] = true;
+	}
+}
+
+void USCharacterInteractor::ComputeDerivedFeatures()
+{
+	FSCharacterObservationBatch& Batch = ObservationBatch;
+
+	// Pure arithmetic on the snapshot, safe to split across worker threads
+	ParallelFor(TEXT("SCharacterInteractor.DerivedFeatures"), Batch.Locations.Num(), ParallelGatherMinBatchSize,
+		[&Batch](const int32 Index)
+		{
+			const FVector ToTarget = Batch.TargetLocations[Index] - Batch.Locations[Index];
+			const float Distance = ToTarget.Size();
+			const FVector Direction = Distance > UE_SMALL_NUMBER ? ToTarget / Distance : FVector::ZeroVector;
+
+			Batch.DirectionsToTarget[Index] = Direction;
+			Batch.DistancesToTarget[Index] = Distance;
+			Batch.FacingAlignments[Index] = FVector::DotProduct(Batch.Forwards[Index], Direction);
+		});
+}
+
+void USCharacterInteractor::ComputeObstacleRays(const TArray<int32>& AgentIds)
+{
+	const int32 RayNum = SpecifiedObstacleRayNum;
+	FSCharacterObservationBatch& Batch = ObservationBatch;
+	Batch.ObstacleRayDistances.SetNumUninitialized(AgentIds.Num() * RayNum, EAllowShrinking::No);
+	Batch.WorldRayDirections.SetNumUninitialized(AgentIds.Num() * RayNum, EAllowShrinking::No);
+
+	const USCharacterManagerComponent* ArenaManager = Cast<USCharacterManagerComponent>(Manager);
+	const FSCharacterPointMassSim* Sim = ArenaManager ? ArenaManager->GetPointMassSim() : nullptr;
+	const float RayLength = ObstacleRayLength;
+	const float InvRayLength = 1.0f / RayLength;
+	TConstArrayView<FVector2f> LocalDirections = ObstacleRayDirections;
+
+	// Obstacles only change on resets, so reading them from worker threads mid-step is safe
+	ParallelFor(TEXT("SCharacterInteractor.ObstacleRays"), AgentIds.Num(), ParallelGatherMinBatchSize,
+		[&Batch, &AgentIds, Sim, RayNum, RayLength, InvRayLength, LocalDirections](const int32 Index)
+		{
+			TArrayView<float> Distances = MakeArrayView(Batch.ObstacleRayDistances.GetData() + Index * RayNum, RayNum);
+			const USObstacleManager* ArenaObstacles = Batch.ObstacleManagers[Index];
+			if (!Batch.bValid[Index] || (!Sim && !ArenaObstacles))
+			{
+				for (float& Distance : Distances)
+				{
+					Distance = 1.0f;
+				}
+				return;
+			}
+
+			// Rotate the fan from the agent's frame into the world by its yaw
+			const FVector2f Forward = FVector2f(Batch.Forwards[Index].X, Batch.Forwards[Index].Y).GetSafeNormal();
+			TArrayView<FVector2f> WorldDirections = MakeArrayView(Batch.WorldRayDirections.GetData() + Index * RayNum, RayNum);
+			for (int32 Ray = 0; Ray < RayNum; Ray++)
+			{
+				const FVector2f& Local = LocalDirections[Ray];
+				WorldDirections[Ray] = FVector2f(Local.X * Forward.X - Local.Y * Forward.Y, Local.X * Forward.Y + Local.Y * Forward.X);
+			}
+
+			if (Sim)
+			{
+				Sim->TraceObstacleRays(AgentIds[Index], WorldDirections, RayLength, Distances);
+			}
+			else
+			{
+				ArenaObstacles->TraceObstacleRays(Batch.Locations[Index], WorldDirections, RayLength, Distances);
+			}
+
+			for (float& Distance : Distances)
+			{
+				Distance *= InvRayLength;
+			}
+		});
+}
+
+void USCharacterInteractor::ComputeOccupancyGrids(const TArray<int32>& AgentIds)
+{
+	const int32 CellNum = OccupancyCellCenters.Num();
+	FSCharacterObservationBatch& Batch = ObservationBatch;
+	Batch.OccupancyGrids.SetNumUninitialized(AgentIds.Num() * CellNum, EAllowShrinking::No);
+	Batch.WorldCellCenters.SetNumUninitialized(AgentIds.Num() * CellNum, EAllowShrinking::No);
+	Batch.CellBlocked.SetNumUninitialized(AgentIds.Num() * CellNum, EAllowShrinking::No);
+
+	const USCharacterManagerComponent* ArenaManager = Cast<USCharacterManagerComponent>(Manager);
+	const FSCharacterPointMassSim* Sim = ArenaManager ? ArenaManager->GetPointMassSim() : nullptr;
+
+	// A cell counts as occupied when an obstacle comes within half a cell of its center
+	const float CellRadius = OccupancyCellSize * 0.5f;
+	TConstArrayView<FVector2f> LocalCenters = OccupancyCellCenters;
+
+	ParallelFor(TEXT("SCharacterInteractor.OccupancyGrids"), AgentIds.Num(), ParallelGatherMinBatchSize,
+		[&Batch, &AgentIds, Sim, CellNum, CellRadius, LocalCenters](const int32 Index)
+		{
+			TArrayView<float> Cells = MakeArrayView(Batch.OccupancyGrids.GetData() + Index * CellNum, CellNum);
+			const USObstacleManager* ArenaObstacles = Batch.ObstacleManagers[Index];
+			if (!Batch.bValid[Index] || (!Sim && !ArenaObstacles))
+			{
+				for (float& Cell : Cells)
+				{
+					Cell = 0.0f;
+				}
+				return;
+			}
+
+			// Cell centers rotated from the agent's frame into the world by its yaw
+			const FVector& Origin = Batch.Locations[Index];
+			const FVector2f Forward = FVector2f(Batch.Forwards[Index].X, Batch.Forwards[Index].Y).GetSafeNormal();
+			const FVector2f Right(-Forward.Y, Forward.X);
+
+			if (Sim)
+			{
+				for (int32 Cell = 0; Cell < CellNum; Cell++)
+				{
+					const FVector2f Center = FVector2f(Origin.X, Origin.Y) + Forward * LocalCenters[Cell].X + Right * LocalCenters[Cell].Y;
+					Cells[Cell] = Sim->IsLocationBlocked(AgentIds[Index], Center, CellRadius) ? 1.0f : 0.0f;
+				}
+				return;
+			}
+
+			TArrayView<FVector> WorldCenters = MakeArrayView(Batch.WorldCellCenters.GetData() + Index * CellNum, CellNum);
+			TArrayView<bool> Blocked = MakeArrayView(Batch.CellBlocked.GetData() + Index * CellNum, CellNum);
+			for (int32 Cell = 0; Cell < CellNum; Cell++)
+			{
+				const FVector2f Offset = Forward * LocalCenters[Cell].X + Right * LocalCenters[Cell].Y;
+				WorldCenters[Cell] = FVector(Origin.X + Offset.X, Origin.Y + Offset.Y, Origin.Z);
+			}
+
+			ArenaObstacles->AreLocationsBlocked(WorldCenters, CellRadius, Blocked);
+			for (int32 Cell = 0; Cell < CellNum; Cell++)
+			{
+				Cells[Cell] = Blocked[Cell] ? 1.0f : 0.0f;
+			}
+		});
+}
+
+void USCharacterInteractor::ComputeObservationHistories(const TArray<int32>& AgentIds)
+{
+	using namespace SCharacterInteractorLayout;
+
+	const int32 HistoryLength = SpecifiedHistoryLength;
+	const int32 RingSize = HistoryLength + 1;
+	const int32 FrameSize = HistoryFrameSize;
+	const int32 RayNum = SpecifiedObstacleRayNum;
+	const int32 CellNum = OccupancyCellCenters.Num();
+	const float InvDistance = 1.0f / MaxObservationDistance;
+	const float InvVelocity = 1.0f / MaxVelocity;
+
+	FSCharacterObservationBatch& Batch = ObservationBatch;
+	Batch.StackedHistories.SetNumUninitialized(AgentIds.Num() * HistoryLength * FrameSize, EAllowShrinking::No);
+
+	float* Rings = HistoryFrames.GetData();
+	int32* Heads = HistoryHeads.GetData();
+	bool* Filled = bHistoryFilled.GetData();
+	const int32 RingAgentNum = HistoryHeads.Num();
+
+	// Every agent owns its ring, so agents can be stacked on worker threads
+	ParallelFor(TEXT("SCharacterInteractor.ObservationHistories"), AgentIds.Num(), ParallelGatherMinBatchSize,
+		[&Batch, &AgentIds, Rings, Heads, Filled, RingAgentNum, HistoryLength, RingSize, FrameSize, RayNum, CellNum, InvDistance, InvVelocity](const int32 Index)
+		{
+			float* Stacked = Batch.StackedHistories.GetData() + Index * HistoryLength * FrameSize;
+			const int32 AgentId = AgentIds[Index];
+			if (!Batch.bValid[Index] || AgentId < 0 || AgentId >= RingAgentNum)
+			{
+				FMemory::Memzero(Stacked, HistoryLength * FrameSize * sizeof(float));
+				return;
+			}
+
+			float* Ring = Rings + AgentId * RingSize * FrameSize;
+			int32& Head = Heads[AgentId];
+
+			// Current frame in the same normalized units the fixed elements are encoded with
+			float* Frame = Ring + Head * FrameSize;
+			const FVector* Vectors[] = { &Batch.Locations[Index], &Batch.Velocities[Index], &Batch.Forwards[Index], &Batch.TargetLocations[Index], &Batch.DirectionsToTarget[Index] };
+			const float Scales[] = { InvDistance, InvVelocity, 1.0f, InvDistance, 1.0f };
+			for (int32 Vector = 0; Vector < (int32)UE_ARRAY_COUNT(Vectors); Vector++)
+			{
+				Frame[Vector * 3 + 0] = Vectors[Vector]->X * Scales[Vector];
+				Frame[Vector * 3 + 1] = Vectors[Vector]->Y * Scales[Vector];
+				Frame[Vector * 3 + 2] = Vectors[Vector]->Z * Scales[Vector];
+			}
+			Frame[15] = Batch.DistancesToTarget[Index] * InvDistance;
+			Frame[16] = Batch.FacingAlignments[Index];
+			static_assert(HistoryFixedFrameSize == 17, "Frame layout above has to match HistoryFixedFrameSize");
+			if (RayNum > 0)
+			{
+				FMemory::Memcpy(Frame + HistoryFixedFrameSize, Batch.ObstacleRayDistances.GetData() + Index * RayNum, RayNum * sizeof(float));
+			}
+			if (CellNum > 0)
+			{
+				FMemory::Memcpy(Frame + HistoryFixedFrameSize + RayNum, Batch.OccupancyGrids.GetData() + Index * CellNum, CellNum * sizeof(float));
+			}
+
+			// A fresh episode has no past yet, so its history starts as copies of the first frame
+			if (!Filled[AgentId])
+			{
+				for (int32 Slot = 0; Slot < RingSize; Slot++)
+				{
+					if (Slot != Head)
+					{
+						FMemory::Memcpy(Ring + Slot * FrameSize, Frame, FrameSize * sizeof(float));
+					}
+				}
+				Filled[AgentId] = true;
+			}
+
+			// Emit the frames before the current one newest first, the current one stays in the ring for the next step
+			for (int32 Age = 1; Age <= HistoryLength; Age++)
+			{
+				const int32 Slot = (Head + RingSize - Age) % RingSize;
+				FMemory::Memcpy(Stacked + (Age - 1) * FrameSize, Ring + Slot * FrameSize, FrameSize * sizeof(float));
+			}
+			Head = (Head + 1) % RingSize;
+		});
+}
+
+void USCharacterInteractor::ClearObservationHistories(const TArray<int32>& AgentIds)
+{
+	for (const int32 AgentId : AgentIds)
 	{
-		CharacterVelocity = MovementComp->Velocity;
+		if (bHistoryFilled.IsValidIndex(AgentId))
+		{
+			bHistoryFilled[AgentId] = false;
+		}
 	}
-	CharacterObservationObject.Add("CharacterVelocity", 
-		ULearningAgentsObservations::MakeVelocityObservation(InObservationObject, CharacterVelocity));
+}
 
-	// Character forward direction
-	CharacterObservationObject.Add("CharacterDirection", 
-		ULearningAgentsObservations::MakeDirectionObservation(InObservationObject, Character->GetActorForwardVector()));
+void USCharacterInteractor::OnAgentsAdded_Implementation(const TArray<int32>& AgentIds)
+{
+	const USCharacterManagerComponent* ArenaManager = Cast<USCharacterManagerComponent>(Manager);
+	ensureMsgf(!ArenaManager || !ArenaManager->IsInferenceInFlight(), TEXT("SCharacterInteractor: Agents added while a policy evaluation is in flight, use AddAgentAfterInference"));
 
-	// Target location
-	CharacterObservationObject.Add("TargetLocation", 
-		ULearningAgentsObservations::MakeLocationObservation(InObservationObject, TargetActor->GetActorLocation()));
+	Super::OnAgentsAdded_Implementation(AgentIds);
+	ClearObservationHistories(AgentIds);
+}
 
-	// Direction from character to target
-	FVector DirectionToTarget = (TargetActor->GetActorLocation() - Character->GetActorLocation()).GetSafeNormal();
-	CharacterObservationObject.Add("DirectionToTarget", 
-		ULearningAgentsObservations::MakeDirectionObservation(InObservationObject, DirectionToTarget));
+void USCharacterInteractor::OnAgentsRemoved_Implementation(const TArray<int32>& AgentIds)
+{
+	const USCharacterManagerComponent* ArenaManager = Cast<USCharacterManagerComponent>(Manager);
+	ensureMsgf(!ArenaManager || !ArenaManager->IsInferenceInFlight(), TEXT("SCharacterInteractor: Agents removed while a policy evaluation is in flight, use RemoveAgentAfterInference"));
 
-	// Distance to target
-	float DistanceToTarget = FVector::Dist(Character->GetActorLocation(), TargetActor->GetActorLocation());
-	CharacterObservationObject.Add("DistanceToTarget", 
-		ULearningAgentsObservations::MakeFloatObservation(InObservationObject, DistanceToTarget));
+	Super::OnAgentsRemoved_Implementation(AgentIds);
+}
+
+void USCharacterInteractor::OnAgentsReset_Implementation(const TArray<int32>& AgentIds)
+{
+	Super::OnAgentsReset_Implementation(AgentIds);
+	ClearObservationHistories(AgentIds);
+}
+
+void USCharacterInteractor::GatherAgentObservations_Implementation(
+	TArray<FLearningAgentsObservationObjectElement>& OutObservationObjectElements,
+	ULearningAgentsObservationObject* InObservationObject, const TArray<int32>& AgentIds)
+{
+	using namespace SCharacterInteractorLayout;
+	SCOPE_COOP_TRAINING_STAGE(GatherObservations);
+
+	OutObservationObjectElements.Reset();
+	OutObservationObjectElements.SetNum(AgentIds.Num());
+
+	const USCharacterManagerComponent* ArenaManager = Cast<USCharacterManagerComponent>(Manager);
+	if (!TargetActor && !(ArenaManager && ArenaManager->GetPointMassSim()))
+	{
+		UE_LOG(LogTemp, Error, TEXT("SCharacterInteractor: TargetActor is NULL - make sure SCharacterManager.TargetActor is set!"));
+		return;
+	}
+
+	// One pass over the agents, then one kernel over the contiguous snapshot
+	GatherObservationSnapshot(AgentIds);
+	ComputeObservationFeatures(AgentIds);
+	const int32 OccupancyCellNum = OccupancyCellCenters.Num();
+
+	// Encoding writes into the observation object, which is not thread safe
+	FLearningAgentsObservationObjectElement CharacterObservations[ObservationElementNum];
+	for (int32 Index = 0; Index < AgentIds.Num(); Index++)
+	{
+		if (!ObservationBatch.bValid[Index])
+		{
+			continue;
+		}
+
+		CharacterObservations[CharacterLocation] = ULearningAgentsObservations::MakeLocationObservation(
+			InObservationObject, ObservationBatch.Locations[Index], FTransform::Identity, LocationTag);
+
+		CharacterObservations[CharacterVelocity] = ULearningAgentsObservations::MakeVelocityObservation(
+			InObservationObject, ObservationBatch.Velocities[Index], FTransform::Identity, VelocityTag);
+
+		CharacterObservations[CharacterDirection] = ULearningAgentsObservations::MakeDirectionObservation(
+			InObservationObject, ObservationBatch.Forwards[Index], FTransform::Identity, DirectionTag);
+
+		CharacterObservations[TargetLocation] = ULearningAgentsObservations::MakeLocationObservation(
+			InObservationObject, ObservationBatch.TargetLocations[Index], FTransform::Identity, LocationTag);
+
+		CharacterObservations[DirectionToTarget] = ULearningAgentsObservations::MakeDirectionObservation(
+			InObservationObject, ObservationBatch.DirectionsToTarget[Index], FTransform::Identity, DirectionTag);
+
+		CharacterObservations[DistanceToTarget] = ULearningAgentsObservations::MakeFloatObservation(
+			InObservationObject, ObservationBatch.DistancesToTarget[Index], FloatObservationTag);
 
-	// Facing angle to target (how well aligned the character is with the target)
-	FVector CharacterForward = Character->GetActorForwardVector();
-	float FacingAlignment = FVector::DotProduct(CharacterForward, DirectionToTarget);
-	CharacterObservationObject.Add("FacingAlignment", 
-		ULearningAgentsObservations::MakeFloatObservation(InObservationObject, FacingAlignment));
+		CharacterObservations[FacingAlignment] = ULearningAgentsObservations::MakeFloatObservation(
+			InObservationObject, ObservationBatch.FacingAlignments[Index], FloatObservationTag);
 
-	// Set the complete observation object
-	OutObservationObjectElement = ULearningAgentsObservations::MakeStructObservation(InObservationObject, CharacterObservationObject);
+		if (ObstacleRaySlot != INDEX_NONE)
+		{
+			CharacterObservations[ObstacleRaySlot] = ULearningAgentsObservations::MakeContinuousObservationFromArrayView(InObservationObject,
+				MakeArrayView(ObservationBatch.ObstacleRayDistances.GetData() + Index * SpecifiedObstacleRayNum, SpecifiedObstacleRayNum), ContinuousObservationTag);
+		}
+
+		if (OccupancyGridSlot != INDEX_NONE)
+		{
+			CharacterObservations[OccupancyGridSlot] = ULearningAgentsObservations::MakeContinuousObservationFromArrayView(InObservationObject,
+				MakeArrayView(ObservationBatch.OccupancyGrids.GetData() + Index * OccupancyCellNum, OccupancyCellNum), ContinuousObservationTag);
+		}
+
+		if (ObservationHistorySlot != INDEX_NONE)
+		{
+			const int32 StackedNum = SpecifiedHistoryLength * HistoryFrameSize;
+			CharacterObservations[ObservationHistorySlot] = ULearningAgentsObservations::MakeContinuousObservationFromArrayView(InObservationObject,
+				MakeArrayView(ObservationBatch.StackedHistories.GetData() + Index * StackedNum, StackedNum), ContinuousObservationTag);
+		}
+
+		OutObservationObjectElements[Index] = ULearningAgentsObservations::MakeStructObservationFromArrayViews(InObservationObject,
+			ObservationElementNames, MakeArrayView(CharacterObservations, ObservationElementNames.Num()), StructObservationTag);
+	}
+}
+
+void USCharacterInteractor::ComputeObservationFeatures(const TArray<int32>& AgentIds)
+{
+	ComputeDerivedFeatures();
+	if (SpecifiedObstacleRayNum > 0)
+	{
+		ComputeObstacleRays(AgentIds);
+	}
+	if (SpecifiedOccupancyGridSize > 0)
+	{
+		ComputeOccupancyGrids(AgentIds);
+	}
+	if (SpecifiedHistoryLength > 0)
+	{
+		ComputeObservationHistories(AgentIds);
+	}
+
+	TrackScratchBufferGrowth();
 }
 
 void USCharacterInteractor::SpecifyAgentAction_Implementation(
 	FLearningAgentsActionSchemaElement& OutActionSchemaElement,
 	ULearningAgentsActionSchema* InActionSchema)
 {
-	// Define actions for character movement
-	TMap<FName, FLearningAgentsActionSchemaElement> CharacterActions;
+	using namespace SCharacterInteractorLayout;
+
+	// Define actions for character movement, one slot per layout entry
+	FLearningAgentsActionSchemaElement CharacterActions[ActionElementNum];
 
 	// Movement input (forward/backward)
-	CharacterActions.Add("MoveForward", 
-		ULearningAgentsActions::SpecifyFloatAction(InActionSchema, 1.0f, "FloatAction"));
+	CharacterActions[MoveForward] = ULearningAgentsActions::SpecifyFloatAction(InActionSchema, 1.0f, FloatActionTag);
 
 	// Movement input (left/right)
-	CharacterActions.Add("MoveRight", 
-		ULearningAgentsActions::SpecifyFloatAction(InActionSchema, 1.0f, "FloatAction"));
+	CharacterActions[MoveRight] = ULearningAgentsActions::SpecifyFloatAction(InActionSchema, 1.0f, FloatActionTag);
 
 	// Rotation input (yaw)
-	CharacterActions.Add("Turn", 
-		ULearningAgentsActions::SpecifyFloatAction(InActionSchema, 1.0f, "FloatAction"));
+	CharacterActions[Turn] = ULearningAgentsActions::SpecifyFloatAction(InActionSchema, 1.0f, FloatActionTag);
 
 	// Set the complete action schema
-	OutActionSchemaElement = ULearningAgentsActions::SpecifyStructAction(InActionSchema, CharacterActions);
+	OutActionSchemaElement = ULearningAgentsActions::SpecifyStructActionFromArrayViews(
+		InActionSchema, MakeArrayView(ActionNames), MakeArrayView(CharacterActions), StructActionTag);
 }
 
 void USCharacterInteractor::PerformAgentAction_Implementation(
@@ -146,65 +650,134 @@ void USCharacterInteractor::PerformAgentAction_Implementation(
 	const FLearningAgentsActionObjectElement& InActionObjectElement,
 	const int32 AgentId)
 {
-	// Get the character agent
-	ASCharacter* Character = Cast<ASCharacter>(Manager->GetAgent(AgentId, ASCharacter::StaticClass()));
-	
-	if (!Character)
-	{
-		UE_LOG(LogTemp, Error, TEXT("SCharacterInteractor: Failed to get character for agent %d in PerformAgentAction"), AgentId);
-		return;
-	}
+	SingleActionObjectElements.Reset();
+	SingleActionObjectElements.Add(InActionObjectElement);
+	SingleAgentIds.Reset();
+	SingleAgentIds.Add(AgentId);
+	PerformAgentActions_Implementation(InActionObject, SingleActionObjectElements, SingleAgentIds);
+}
+
+void USCharacterInteractor::PerformAgentActions_Implementation(
+	const ULearningAgentsActionObject* InActionObject,
+	const TArray<FLearningAgentsActionObjectElement>& InActionObjectElements,
+	const TArray<int32>& AgentIds)
+{
+	using namespace SCharacterInteractorLayout;
+	SCOPE_COOP_TRAINING_STAGE(PerformActions);
 
-	// Extract actions from the action object
-	TMap<FName, FLearningAgentsActionObjectElement> CharacterActionObjects;
-	if (!ULearningAgentsActions::GetStructAction(CharacterActionObjects, InActionObject, InActionObjectElement))
+	// Decode every agent's action into the held actions first, then apply them all in one pass
+	for (int32 Index = 0; Index < AgentIds.Num(); Index++)
 	{
-		UE_LOG(LogTemp, Error, TEXT("SCharacterInteractor: Failed to get struct action for agent %d"), AgentId);
-		return;
-	}
+		const int32 AgentId = AgentIds[Index];
 
-	// Get movement actions
-	float MoveForwardValue = 0.0f;
-	float MoveRightValue = 0.0f;
-	float TurnValue = 0.0f;
+		// Extract actions from the action object straight into the fixed layout slots
+		FLearningAgentsActionObjectElement CharacterActionObjects[ActionElementNum];
+		if (!ULearningAgentsActions::GetStructActionToArrayViews(
+			MakeArrayView(CharacterActionObjects), InActionObject, InActionObjectElements[Index], MakeArrayView(ActionNames), StructActionTag))
+		{
+			UE_LOG(LogTemp, Error, TEXT("SCharacterInteractor: Failed to get struct action for agent %d"), AgentId);
+			continue;
+		}
 
-	const FLearningAgentsActionObjectElement* MoveForwardAction = CharacterActionObjects.Find("MoveForward");
-	if (MoveForwardAction && !ULearningAgentsActions::GetFloatAction(MoveForwardValue, InActionObject, *MoveForwardAction))
-	{
-		UE_LOG(LogTemp, Error, TEXT("SCharacterInteractor: Failed to get MoveForward action for agent %d"), AgentId);
-	}
+		// Get movement actions
+		float MoveForwardValue = 0.0f;
+		float MoveRightValue = 0.0f;
+		float TurnValue = 0.0f;
 
-	const FLearningAgentsActionObjectElement* MoveRightAction = CharacterActionObjects.Find("MoveRight");
-	if (MoveRightAction && !ULearningAgentsActions::GetFloatAction(MoveRightValue, InActionObject, *MoveRightAction))
-	{
-		UE_LOG(LogTemp, Error, TEXT("SCharacterInteractor: Failed to get MoveRight action for agent %d"), AgentId);
+		if (!ULearningAgentsActions::GetFloatAction(MoveForwardValue, InActionObject, CharacterActionObjects[MoveForward], FloatActionTag))
+		{
+			UE_LOG(LogTemp, Error, TEXT("SCharacterInteractor: Failed to get MoveForward action for agent %d"), AgentId);
+		}
+
+		if (!ULearningAgentsActions::GetFloatAction(MoveRightValue, InActionObject, CharacterActionObjects[MoveRight], FloatActionTag))
+		{
+			UE_LOG(LogTemp, Error, TEXT("SCharacterInteractor: Failed to get MoveRight action for agent %d"), AgentId);
+		}
+
+		if (!ULearningAgentsActions::GetFloatAction(TurnValue, InActionObject, CharacterActionObjects[Turn], FloatActionTag))
+		{
+			UE_LOG(LogTemp, Error, TEXT("SCharacterInteractor: Failed to get Turn action for agent %d"), AgentId);
+		}
+
+		// Kept so the action can be held over the steps until the next decision
+		if (HeldActions.IsValidIndex(AgentId))
+		{
+			HeldActions[AgentId] = FVector3f(MoveForwardValue, MoveRightValue, TurnValue);
+		}
 	}
 
-	const FLearningAgentsActionObjectElement* TurnAction = CharacterActionObjects.Find("Turn");
-	if (TurnAction && !ULearningAgentsActions::GetFloatAction(TurnValue, InActionObject, *TurnAction))
+	ApplyActions(AgentIds);
+	TrackScratchBufferGrowth();
+}
+
+void USCharacterInteractor::ApplyHeldActions(const TArray<int32>& AgentIds)
+{
+	SCOPE_COOP_TRAINING_STAGE(PerformActions);
+
+	// Movement input is consumed every frame, so a held action has to be fed again each step
+	ApplyActions(AgentIds);
+}
+
+void USCharacterInteractor::ApplyActions(const TArray<int32>& AgentIds)
+{
+	// Point-mass agents apply the action on the simulator's next step
+	const USCharacterManagerComponent* ArenaManager = Cast<USCharacterManagerComponent>(Manager);
+	if (FSCharacterPointMassSim* Sim = ArenaManager ? ArenaManager->GetPointMassSim() : nullptr)
 	{
-		UE_LOG(LogTemp, Error, TEXT("SCharacterInteractor: Failed to get Turn action for agent %d"), AgentId);
+		for (const int32 AgentId : AgentIds)
+		{
+			if (HeldActions.IsValidIndex(AgentId))
+			{
+				const FVector3f& Action = HeldActions[AgentId];
+				Sim->SetAction(AgentId, Action.X, Action.Y, Action.Z);
+			}
+		}
+		return;
 	}
 
-	// Apply movement actions to the character
-	if (Character)
+	for (const int32 AgentId : AgentIds)
 	{
-		// Log action execution for debugging multi-agent issues
-		// UE_LOG(LogTemp, Log, TEXT("Agent %d (%s): Actions - Forward:%.2f, Right:%.2f, Turn:%.2f"), 
-		//	AgentId, *Character->GetName(), MoveForwardValue, MoveRightValue, TurnValue);
-		
-		// Apply forward/backward movement
-		Character->AddMovementInput(Character->GetActorForwardVector(), MoveForwardValue);
-		
-		// Apply left/right movement  
-		Character->AddMovementInput(Character->GetActorRightVector(), MoveRightValue);
-		
-		// Apply rotation (yaw) with increased sensitivity for better target facing
-		if (FMath::Abs(TurnValue) > 0.01f) // Only rotate if meaningful input
+		if (!HeldActions.IsValidIndex(AgentId))
+		{
+			continue;
+		}
+
+		// GetAgent already checks the class, so no further cast is needed
+		ASCharacter* Character = static_cast<ASCharacter*>(Manager->GetAgent(AgentId, ASCharacter::StaticClass()));
+		UCharacterMovementComponent* MovementComponent = Character ? Character->GetCharacterMovement() : nullptr;
+
+		if (!MovementComponent)
 		{
-			// Scale up the turn input for more responsive rotation
-			float TurnScale = 2.0f; // Increase rotation sensitivity
-			Character->AddControllerYawInput(TurnValue * TurnScale);
+			UE_LOG(LogTemp, Error, TEXT("SCharacterInteractor: Failed to get character movement for agent %d in PerformAgentActions"), AgentId);
+			continue;
 		}
+
+		const FVector3f& Action = HeldActions[AgentId];
+
+		// Turn first so the movement is relative to the new facing, like the point-mass simulator.
+		// Yaw is written to the actor, AddControllerYawInput only reaches player controllers
+		FRotator Rotation = Character->GetActorRotation();
+		if (TurnDegreesPerStep > 0.0f && FMath::Abs(Action.Z) > 0.01f)
+		{
+			Rotation.Yaw = FMath::UnwindDegrees(Rotation.Yaw + Action.Z * TurnDegreesPerStep);
+			Character->SetActorRotation(Rotation);
+
+			// A pawn following its controller's yaw would be turned back on the next controller update
+			AController* Controller = Character->GetController();
+			if (Controller && Character->bUseControllerRotationYaw)
+			{
+				FRotator ControlRotation = Controller->GetControlRotation();
+				ControlRotation.Yaw = Rotation.Yaw;
+				Controller->SetControlRotation(ControlRotation);
+			}
+		}
+
+		// Forward and right combined into one input vector, fed straight to the movement component
+		float SinYaw = 0.0f;
+		float CosYaw = 0.0f;
+		FMath::SinCos(&SinYaw, &CosYaw, FMath::DegreesToRadians((float)Rotation.Yaw));
+		const FVector Forward(CosYaw, SinYaw, 0.0f);
+		const FVector Right(-SinYaw, CosYaw, 0.0f);
+		MovementComponent->AddInputVector(Forward * Action.X + Right * Action.Y);
 	}
-} 
\ No newline at end of file
+}
@@ -7,6 +7,82 @@
 #include "SCharacterInteractor.generated.h"
 
 class ASTargetActor;
+class USObstacleManager;
+
+/**
+ * Fixed observation/action layout shared by the schema and the per-step encode/decode
+ */
+namespace SCharacterInteractorLayout
+{
+	enum EObservationElement : int32
+	{
+		CharacterLocation,
+		CharacterVelocity,
+		CharacterDirection,
+		TargetLocation,
+		DirectionToTarget,
+		DistanceToTarget,
+		FacingAlignment,
+		FixedObservationElementNum,
+
+		// Optional, appended after the fixed elements in this order when enabled
+		ObstacleRays = FixedObservationElementNum,
+		OccupancyGrid,
+		ObservationHistory,
+		ObservationElementNum
+	};
+
+	// Floats of one history frame taken from the fixed elements, the rays and occupancy cells follow them
+	static constexpr int32 HistoryFixedFrameSize = 17;
+
+	enum EActionElement : int32
+	{
+		MoveForward,
+		MoveRight,
+		Turn,
+		ActionElementNum
+	};
+}
+
+/**
+ * Structure-of-arrays snapshot of every agent gathered in a single pass
+ */
+struct FSCharacterObservationBatch
+{
+	TArray<FVector> Locations;
+	TArray<FVector> Velocities;
+	TArray<FVector> Forwards;
+	TArray<FVector> TargetLocations;
+	TArray<FVector> DirectionsToTarget;
+	TArray<float> DistancesToTarget;
+	TArray<float> FacingAlignments;
+	TArray<const USObstacleManager*> ObstacleManagers;
+	TArray<bool> bValid;
+
+	// ObstacleRayNum normalized hit distances per agent, agent-major
+	TArray<float> ObstacleRayDistances;
+
+	// The ray fan rotated into the world per agent, agent-major, so the parallel kernel never allocates
+	TArray<FVector2f> WorldRayDirections;
+
+	// OccupancyGridSize^2 cells per agent, agent-major, 1 where an obstacle covers the cell
+	TArray<float> OccupancyGrids;
+
+	// Grid cell centers in the world and their blocked flags per agent, agent-major, scratch for the batched query
+	TArray<FVector> WorldCellCenters;
+	TArray<bool> CellBlocked;
+
+	// ObservationHistoryLength previous frames per agent, agent-major, newest first
+	TArray<float> StackedHistories;
+
+	// Resize every column without shrinking the underlying allocations
+	void SetNum(const int32 Num);
+
+	// Preallocate every column for the given agent count
+	void Reserve(const int32 Num);
+
+	SIZE_T GetAllocatedSize() const;
+};
 
 /**
  * Interactor for SCharacter learning agents
@@ -23,10 +99,10 @@ public:
 		FLearningAgentsObservationSchemaElement& OutObservationSchemaElement,
 		ULearningAgentsObservationSchema* InObservationSchema) override;
 
-	virtual void GatherAgentObservation_Implementation(
-		FLearningAgentsObservationObjectElement& OutObservationObjectElement,
+	virtual void GatherAgentObservations_Implementation(
+		TArray<FLearningAgentsObservationObjectElement>& OutObservationObjectElements,
 		ULearningAgentsObservationObject* InObservationObject,
-		const int32 AgentId) override;
+		const TArray<int32>& AgentIds) override;
 	
 	virtual void SpecifyAgentAction_Implementation(
 		FLearningAgentsActionSchemaElement& OutActionSchemaElement,
@@ -37,6 +113,17 @@ public:
 		const FLearningAgentsActionObjectElement& InActionObjectElement,
 		const int32 AgentId) override;
 
+	virtual void PerformAgentActions_Implementation(
+		const ULearningAgentsActionObject* InActionObject,
+		const TArray<FLearningAgentsActionObjectElement>& InActionObjectElements,
+		const TArray<int32>& AgentIds) override;
+
+	virtual void OnAgentsAdded_Implementation(const TArray<int32>& AgentIds) override;
+
+	virtual void OnAgentsRemoved_Implementation(const TArray<int32>& AgentIds) override;
+
+	virtual void OnAgentsReset_Implementation(const TArray<int32>& AgentIds) override;
+
 	// Reference to the target actor
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Learning")
 	ASTargetActor* TargetActor;
@@ -47,4 +134,121 @@ public:
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Observations")
 	float MaxVelocity = 1000.0f;
+
+	// Obstacle distance rays fanned around the agent's facing, 0 leaves them out of the observation
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Observations", meta = (ClampMin = 0))
+	int32 ObstacleRayNum = 0;
+
+	// Rays report distances up to this length, normalized to 0..1
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Observations", meta = (ClampMin = 1))
+	float ObstacleRayLength = 1000.0f;
+
+	// Angle covered by the fan, centered on the agent's facing, 360 surrounds the agent
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Observations", meta = (ClampMin = 0, ClampMax = 360))
+	float ObstacleRayFanAngle = 360.0f;
+
+	// Cells per side of the agent-centered obstacle occupancy grid, rotated with the agent, 0 leaves it out of the observation
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Observations", meta = (ClampMin = 0, ClampMax = 64))
+	int32 OccupancyGridSize = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Observations", meta = (ClampMin = 1))
+	float OccupancyCellSize = 50.0f;
+
+	// Previous observations stacked into the observation so the policy can see motion, 0 leaves them out
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Observations", meta = (ClampMin = 0, ClampMax = 16))
+	int32 ObservationHistoryLength = 0;
+
+	// Yaw change for a full turn action, 0 leaves the turn action without effect on the pawns as under AI controllers before
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Actions", meta = (ClampMin = 0))
+	float TurnDegreesPerStep = 0.0f;
+
+	// Below this many agents the feature kernel runs on the game thread only
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Observations", meta = (ClampMin = 1))
+	int32 ParallelGatherMinBatchSize = 64;
+
+	// Apply each agent's last action again, for the steps between policy decisions
+	void ApplyHeldActions(const TArray<int32>& AgentIds);
+
+	// Number of times a step had to grow the interactor's own scratch buffers after setup, expected to stay at zero.
+	// Covers the snapshot columns, history rings, held actions and action scratch, not the observation object or arrays owned by the framework
+	UFUNCTION(BlueprintCallable, Category = "Observations")
+	int32 GetScratchBufferGrowthCount() const { return ScratchBufferGrowthCount; }
+
+	// Bytes currently allocated by the interactor's own scratch buffers
+	SIZE_T GetScratchAllocatedSize() const;
+
+	// Derive the ray fan, occupancy cells and history frame from the settings and size every scratch buffer for MaxAgentNum agents
+	void SpecifyObservationLayout(const int32 MaxAgentNum);
+
+	// Run every feature kernel over the snapshot in the observation batch, then count any scratch growth
+	void ComputeObservationFeatures(const TArray<int32>& AgentIds);
+
+	// Snapshot the kernels read and write, filled from the agents at the start of every gather
+	FSCharacterObservationBatch& GetObservationBatch() { return ObservationBatch; }
+
+private:
+	// Size scratch buffers for the given maximum agent count
+	void ReserveScratchBuffers(const int32 MaxAgentNum);
+
+	// Count any scratch buffer growth that happened during the last step
+	void TrackScratchBufferGrowth();
+
+	// Read every agent's transform and velocity into the batch snapshot
+	void GatherObservationSnapshot(const TArray<int32>& AgentIds);
+
+	// Compute direction, distance and facing for all agents of the snapshot
+	void ComputeDerivedFeatures();
+
+	// Cast every agent's ray fan against its obstacles, no physics involved so it runs on worker threads
+	void ComputeObstacleRays(const TArray<int32>& AgentIds);
+
+	// Feed every agent's held action to its movement component or to the point-mass simulator, in one pass
+	void ApplyActions(const TArray<int32>& AgentIds);
+
+	// Last action per AgentId as forward, right and turn
+	TArray<FVector3f> HeldActions;
+
+	// Mark every agent's occupancy cells covered by its obstacles, one parallel pass with a fixed cost per agent
+	void ComputeOccupancyGrids(const TArray<int32>& AgentIds);
+
+	// Stack each agent's previous frames from its ring and push the current one, one parallel pass with a fixed cost per agent
+	void ComputeObservationHistories(const TArray<int32>& AgentIds);
+
+	// Start the agents' next history over from their next observation
+	void ClearObservationHistories(const TArray<int32>& AgentIds);
+
+	// Ray count and agent-frame directions the schema was specified with
+	int32 SpecifiedObstacleRayNum = 0;
+	TArray<FVector2f> ObstacleRayDirections;
+
+	// Grid size and agent-frame cell centers the schema was specified with, row-major with rows along the facing
+	int32 SpecifiedOccupancyGridSize = 0;
+	TArray<FVector2f> OccupancyCellCenters;
+
+	// Struct element names in schema order, and where the optional elements landed in it
+	TArray<FName, TInlineAllocator<SCharacterInteractorLayout::ObservationElementNum>> ObservationElementNames;
+	int32 ObstacleRaySlot = INDEX_NONE;
+	int32 OccupancyGridSlot = INDEX_NONE;
+	int32 ObservationHistorySlot = INDEX_NONE;
+
+	// History length and floats per frame the schema was specified with
+	int32 SpecifiedHistoryLength = 0;
+	int32 HistoryFrameSize = 0;
+
+	// One ring per AgentId holding the current frame and the SpecifiedHistoryLength before it, allocated for the manager's maximum agent count
+	TArray<float> HistoryFrames;
+
+	// Ring slot the next frame is written to, and whether the ring holds frames of the current episode
+	TArray<int32> HistoryHeads;
+	TArray<bool> bHistoryFilled;
+
+	// Reused between steps so gathering does not reallocate
+	FSCharacterObservationBatch ObservationBatch;
+
+	// Single-agent calls forwarded to the batched path, reused so they do not build temporary arrays
+	TArray<FLearningAgentsActionObjectElement> SingleActionObjectElements;
+	TArray<int32> SingleAgentIds;
+
+	SIZE_T ScratchAllocatedSize = 0;
+	int32 ScratchBufferGrowthCount = 0;
 }; 
\ No newline at end of file
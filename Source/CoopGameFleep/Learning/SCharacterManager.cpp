@@ -16,6 +16,11 @@
 #include "LearningAgentsEntitiesManagerComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Misc/Paths.h"
+#include "Misc/App.h"
+#include "GameFramework/WorldSettings.h"
+#include "UObject/GarbageCollection.h"
+#include "Engine/StaticMeshActor.h"
+#include "Learning/SCharacterTrainingStats.h"
 
 ASCharacterManager::ASCharacterManager()
 {
@@ -106,6 +111,48 @@ ASCharacterManager::ASCharacterManager()
 		UE_LOG(LogTemp, Log, TEXT("SCharacterManager: ActionEntropyWeight set from command line: %f"), TrainingSettings.ActionEntropyWeight);
 	}
 
+	FString InferenceLatencyStr;
+	if (FParse::Value(*CommandLine, TEXT("-InferenceLatency="), InferenceLatencyStr))
+	{
+		InferenceLatency = FMath::Clamp(FCString::Atoi(*InferenceLatencyStr), 0, 1);
+		UE_LOG(LogTemp, Log, TEXT("SCharacterManager: InferenceLatency set from command line: %d"), InferenceLatency);
+	}
+
+	FString DecisionIntervalStr;
+	if (FParse::Value(*CommandLine, TEXT("-DecisionInterval="), DecisionIntervalStr))
+	{
+		DecisionInterval = FMath::Max(FCString::Atoi(*DecisionIntervalStr), 1);
+		UE_LOG(LogTemp, Log, TEXT("SCharacterManager: DecisionInterval set from command line: %d"), DecisionInterval);
+	}
+
+	FString TrainingPawnsStr;
+	if (FParse::Value(*CommandLine, TEXT("-TrainingPawns="), TrainingPawnsStr))
+	{
+		bUseTrainingPawns = TrainingPawnsStr.ToBool();
+		UE_LOG(LogTemp, Log, TEXT("SCharacterManager: TrainingPawns set from command line: %s"), bUseTrainingPawns ? TEXT("true") : TEXT("false"));
+	}
+
+	FString NumArenasStr;
+	if (FParse::Value(*CommandLine, TEXT("-NumArenas="), NumArenasStr))
+	{
+		NumArenas = FMath::Max(FCString::Atoi(*NumArenasStr), 1);
+		UE_LOG(LogTemp, Log, TEXT("SCharacterManager: NumArenas set from command line: %d"), NumArenas);
+	}
+
+	FString PerAgentTargetsStr;
+	if (FParse::Value(*CommandLine, TEXT("-PerAgentTargets="), PerAgentTargetsStr))
+	{
+		bPerAgentTargets = PerAgentTargetsStr.ToBool();
+		UE_LOG(LogTemp, Log, TEXT("SCharacterManager: PerAgentTargets set from command line: %s"), bPerAgentTargets ? TEXT("true") : TEXT("false"));
+	}
+
+	FString NumAgentsStr;
+	if (FParse::Value(*CommandLine, TEXT("-NumAgents="), NumAgentsStr))
+	{
+		NumAgents = FMath::Max(FCString::Atoi(*NumAgentsStr), 0);
+		UE_LOG(LogTemp, Log, TEXT("SCharacterManager: NumAgents set from command line: %d"), NumAgents);
+	}
+
 	// Parse obstacle configuration parameters
 	FString UseObstaclesStr;
 	if (FParse::Value(*CommandLine, TEXT("-UseObstacles="), UseObstaclesStr))
@@ -149,6 +196,101 @@ ASCharacterManager::ASCharacterManager()
 		// UE_LOG(LogTemp, Log, TEXT("SCharacterManager: ObstacleMode set from command line: %s"), ObstacleModeStr.Equals(TEXT("Dynamic"), ESearchCase::IgnoreCase) ? TEXT("Dynamic") : TEXT("Static"));
 	}
 
+	FString InstancedObstaclesStr;
+	if (FParse::Value(*CommandLine, TEXT("-InstancedObstacles="), InstancedObstaclesStr))
+	{
+		ObstacleConfig.bUseInstancedObstacles = InstancedObstaclesStr.ToBool();
+		UE_LOG(LogTemp, Log, TEXT("SCharacterManager: InstancedObstacles set from command line: %s"), ObstacleConfig.bUseInstancedObstacles ? TEXT("true") : TEXT("false"));
+	}
+
+	if (FParse::Value(*CommandLine, TEXT("-ObstacleLayoutLibrary="), ObstacleConfig.LayoutLibraryPath))
+	{
+		UE_LOG(LogTemp, Log, TEXT("SCharacterManager: ObstacleLayoutLibrary set from command line: %s"), *ObstacleConfig.LayoutLibraryPath);
+	}
+
+	// Parse observation parameters
+	FString ObstacleRaysStr;
+	if (FParse::Value(*CommandLine, TEXT("-ObstacleRays="), ObstacleRaysStr))
+	{
+		ObservationConfig.ObstacleRayNum = FMath::Max(FCString::Atoi(*ObstacleRaysStr), 0);
+		UE_LOG(LogTemp, Log, TEXT("SCharacterManager: ObstacleRays set from command line: %d"), ObservationConfig.ObstacleRayNum);
+	}
+
+	FString ObstacleRayLengthStr;
+	if (FParse::Value(*CommandLine, TEXT("-ObstacleRayLength="), ObstacleRayLengthStr))
+	{
+		ObservationConfig.ObstacleRayLength = FMath::Max(FCString::Atof(*ObstacleRayLengthStr), 1.0f);
+		UE_LOG(LogTemp, Log, TEXT("SCharacterManager: ObstacleRayLength set from command line: %f"), ObservationConfig.ObstacleRayLength);
+	}
+
+	FString ObstacleRayFanAngleStr;
+	if (FParse::Value(*CommandLine, TEXT("-ObstacleRayFanAngle="), ObstacleRayFanAngleStr))
+	{
+		ObservationConfig.ObstacleRayFanAngle = FMath::Clamp(FCString::Atof(*ObstacleRayFanAngleStr), 0.0f, 360.0f);
+		UE_LOG(LogTemp, Log, TEXT("SCharacterManager: ObstacleRayFanAngle set from command line: %f"), ObservationConfig.ObstacleRayFanAngle);
+	}
+
+	FString OccupancyGridStr;
+	if (FParse::Value(*CommandLine, TEXT("-OccupancyGrid="), OccupancyGridStr))
+	{
+		ObservationConfig.OccupancyGridSize = FMath::Clamp(FCString::Atoi(*OccupancyGridStr), 0, 64);
+		UE_LOG(LogTemp, Log, TEXT("SCharacterManager: OccupancyGrid set from command line: %d"), ObservationConfig.OccupancyGridSize);
+	}
+
+	FString OccupancyCellSizeStr;
+	if (FParse::Value(*CommandLine, TEXT("-OccupancyCellSize="), OccupancyCellSizeStr))
+	{
+		ObservationConfig.OccupancyCellSize = FMath::Max(FCString::Atof(*OccupancyCellSizeStr), 1.0f);
+		UE_LOG(LogTemp, Log, TEXT("SCharacterManager: OccupancyCellSize set from command line: %f"), ObservationConfig.OccupancyCellSize);
+	}
+
+	FString ObservationHistoryStr;
+	if (FParse::Value(*CommandLine, TEXT("-ObservationHistory="), ObservationHistoryStr))
+	{
+		ObservationConfig.ObservationHistoryLength = FMath::Clamp(FCString::Atoi(*ObservationHistoryStr), 0, 16);
+		UE_LOG(LogTemp, Log, TEXT("SCharacterManager: ObservationHistory set from command line: %d"), ObservationConfig.ObservationHistoryLength);
+	}
+
+	// Parse simulation stepping parameters
+	FString SimulationModeStr;
+	if (FParse::Value(*CommandLine, TEXT("-SimulationMode="), SimulationModeStr))
+	{
+		if (SimulationModeStr.Equals(TEXT("FastForward"), ESearchCase::IgnoreCase))
+		{
+			SimulationConfig.SimulationMode = ESCharacterSimulationMode::FastForward;
+		}
+		else if (SimulationModeStr.Equals(TEXT("PointMass"), ESearchCase::IgnoreCase))
+		{
+			SimulationConfig.SimulationMode = ESCharacterSimulationMode::PointMass;
+		}
+		else
+		{
+			SimulationConfig.SimulationMode = ESCharacterSimulationMode::RealTime;
+		}
+		UE_LOG(LogTemp, Log, TEXT("SCharacterManager: SimulationMode set from command line: %s"), *UEnum::GetValueAsString(SimulationConfig.SimulationMode));
+	}
+
+	FString SimStepsPerFrameStr;
+	if (FParse::Value(*CommandLine, TEXT("-SimStepsPerFrame="), SimStepsPerFrameStr))
+	{
+		SimulationConfig.StepsPerFrame = FMath::Max(FCString::Atoi(*SimStepsPerFrameStr), 1);
+		UE_LOG(LogTemp, Log, TEXT("SCharacterManager: SimStepsPerFrame set from command line: %d"), SimulationConfig.StepsPerFrame);
+	}
+
+	FString TurnDegreesPerStepStr;
+	if (FParse::Value(*CommandLine, TEXT("-TurnDegreesPerStep="), TurnDegreesPerStepStr))
+	{
+		SimulationConfig.TurnDegreesPerStep = FMath::Max(FCString::Atof(*TurnDegreesPerStepStr), 0.0f);
+		UE_LOG(LogTemp, Log, TEXT("SCharacterManager: TurnDegreesPerStep set from command line: %f"), SimulationConfig.TurnDegreesPerStep);
+	}
+
+	FString SimDeltaTimeStr;
+	if (FParse::Value(*CommandLine, TEXT("-SimDeltaTime="), SimDeltaTimeStr))
+	{
+		SimulationConfig.FixedStepDeltaTime = FMath::Max(FCString::Atof(*SimDeltaTimeStr), 0.001f);
+		UE_LOG(LogTemp, Log, TEXT("SCharacterManager: SimDeltaTime set from command line: %f"), SimulationConfig.FixedStepDeltaTime);
+	}
+
 	// Only force ReInitialize mode for headless training to ensure fresh neural network initialization
 	if (bIsHeadlessTraining)
 	{
@@ -278,6 +420,9 @@ void ASCharacterManager::BeginPlay()
 {
 	Super::BeginPlay();
 
+	// Configure engine stepping before agents are set up
+	ApplySimulationConfiguration();
+
 	// Initialize the learning system
 	InitializeAgents();
 	InitializeManager();
@@ -320,39 +465,26 @@ void ASCharacterManager::InitializeAgents()
 			SChar ? TEXT("SUCCESS") : TEXT("FAILED"));
 	}
 
+	// Strip the hand-placed agents before spawning more, spawned ones start out stripped
+	if (ShouldUseTrainingPawns())
+	{
+		ApplyTrainingPawnMode(Agents);
+	}
+
+	// Spawn additional agents when more were requested than were placed in the map
+	SpawnAdditionalAgents(Agents);
+
+	// Give every agent without a controller an AI controller for movement input
+	SpawnAgentControllers(Agents);
+
 	for (AActor* Agent : Agents)
 	{
-		// Ensure the agent has a controller for movement input
-		if (APawn* Pawn = Cast<APawn>(Agent))
+		// Add agent to the Learning Agents Manager
+		int32 AgentId = LearningAgentsManager->AddAgentAfterInference(Agent);
+		if (AgentId != INDEX_NONE)
 		{
-			AController* ExistingController = Pawn->GetController();
-			if (!ExistingController)
-			{
-				// Create an AI controller for learning agents
-				UWorld* World = GetWorld();
-				if (World)
-				{
-					AAIController* NewController = World->SpawnActor<AAIController>();
-					if (NewController)
-					{
-						NewController->Possess(Pawn);
-						UE_LOG(LogTemp, Warning, TEXT("SCharacterManager: Created AIController for agent %s"), *Agent->GetName());
-					}
-					else
-					{
-						UE_LOG(LogTemp, Error, TEXT("SCharacterManager: Failed to create AIController for agent %s"), *Agent->GetName());
-					}
-				}
-			}
-			else
-			{
-				UE_LOG(LogTemp, Log, TEXT("SCharacterManager: Agent %s already has controller %s"),
-					*Agent->GetName(), *ExistingController->GetClass()->GetName());
-			}
+			ManagedAgentIds.Add(AgentId);
 		}
-
-		// Add agent to the Learning Agents Manager
-		int32 AgentId = LearningAgentsManager->AddAgent(Agent);
 		UE_LOG(LogTemp, Warning, TEXT("SCharacterManager: Added agent %s to manager with ID %d"), *Agent->GetName(), AgentId);
 
 		// Initialize agent for learning (disable player input, prepare for AI control)
@@ -365,6 +497,9 @@ void ASCharacterManager::InitializeAgents()
 		// Make sure manager ticks first
 		Agent->AddTickPrerequisiteActor(this);
 
+		// Match movement integration to the simulation step size
+		ConfigureAgentSimulation(Agent);
+
 		// If in inference mode, we could reset positions here if needed
 		if (RunMode == ESCharacterManagerMode::Inference)
 		{
@@ -384,6 +519,356 @@ void ASCharacterManager::InitializeAgents()
 	}
 }
 
+void ASCharacterManager::InitializeArenas()
+{
+	UWorld* World = GetWorld();
+	if (!World || !TrainingEnvironment || !TargetActor)
+	{
+		return;
+	}
+
+	const FVector BaseCenter = TrainingEnvironment->ResetCenter;
+	const FVector Bounds = TrainingEnvironment->ResetBounds;
+	const int32 ArenaNum = FMath::Clamp(NumArenas, 1, FMath::Max(ManagedAgentIds.Num(), 1));
+	const int32 GridSize = FMath::CeilToInt(FMath::Sqrt((float)ArenaNum));
+	const FVector TileStep = FVector(Bounds.X * 2.0f + ArenaPadding, Bounds.Y * 2.0f + ArenaPadding, 0.0f);
+
+	// Level geometry only exists under the first arena, find its ground height for the replicated floors
+	float FloorZ = BaseCenter.Z;
+	if (ArenaNum > 1 && bSpawnArenaFloors)
+	{
+		FHitResult HitResult;
+		FCollisionQueryParams QueryParams;
+		QueryParams.AddIgnoredActor(TargetActor);
+		if (World->LineTraceSingleByChannel(HitResult, BaseCenter + FVector(0.0f, 0.0f, 1000.0f), BaseCenter - FVector(0.0f, 0.0f, 1000.0f), ECC_WorldStatic, QueryParams))
+		{
+			FloorZ = HitResult.Location.Z;
+		}
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParams.Template = TargetActor;
+
+	TArray<FSCharacterArena> Arenas;
+	Arenas.SetNum(ArenaNum);
+	for (int32 ArenaIndex = 0; ArenaIndex < ArenaNum; ArenaIndex++)
+	{
+		FSCharacterArena& Arena = Arenas[ArenaIndex];
+		const FVector Offset = FVector(ArenaIndex % GridSize, ArenaIndex / GridSize, 0.0f) * TileStep;
+		Arena.Center = BaseCenter + Offset;
+
+		// The first arena keeps the map's target, the others get a copy of it
+		if (ArenaIndex == 0)
+		{
+			Arena.TargetActor = TargetActor;
+			Arena.bIsPrimary = true;
+			continue;
+		}
+
+		Arena.TargetActor = World->SpawnActor<ASTargetActor>(TargetActor->GetClass(), TargetActor->GetActorLocation() + Offset, TargetActor->GetActorRotation(), SpawnParams);
+		if (bSpawnArenaFloors)
+		{
+			SpawnArenaFloor(Arena.Center, Bounds, FloorZ);
+		}
+	}
+
+	LearningAgentsManager->SetArenas(Arenas, ManagedAgentIds);
+
+	// With per-agent targets every agent after an arena's first gets its own copy of the arena's target, so an
+	// agent resetting never moves the goal of an arena-mate that is still mid-episode
+	int32 AgentTargetNum = 0;
+	for (int32 ArenaIndex = 0; ArenaIndex < ArenaNum && bPerAgentTargets; ArenaIndex++)
+	{
+		const FSCharacterArena& Arena = LearningAgentsManager->GetArena(ArenaIndex);
+		for (int32 Slot = 1; Slot < Arena.AgentIds.Num() && Arena.TargetActor; Slot++)
+		{
+			SpawnParams.Template = Arena.TargetActor;
+			ASTargetActor* AgentTarget = World->SpawnActor<ASTargetActor>(Arena.TargetActor->GetClass(), Arena.TargetActor->GetActorTransform(), SpawnParams);
+			if (!AgentTarget)
+			{
+				continue;
+			}
+
+			// Other agents' targets are no walls, only the reach distance to the agent's own one counts
+			if (UPrimitiveComponent* TargetPrimitive = Cast<UPrimitiveComponent>(AgentTarget->GetRootComponent()))
+			{
+				TargetPrimitive->SetCollisionResponseToChannel(ECC_Pawn, ECR_Ignore);
+			}
+			LearningAgentsManager->SetAgentTarget(Arena.AgentIds[Slot], AgentTarget);
+			AgentTargetNum++;
+		}
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("SCharacterManager: Initialized %d arena(s) for %d agents, %d additional agent target(s)"), ArenaNum, ManagedAgentIds.Num(), AgentTargetNum);
+}
+
+void ASCharacterManager::SpawnArenaFloor(const FVector& ArenaCenter, const FVector& ArenaBounds, float FloorZ)
+{
+	UStaticMesh* CubeMesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+	if (!CubeMesh)
+	{
+		return;
+	}
+
+	// Basic cube is 100 units wide, keep its top face at the first arena's ground height
+	const float FloorThickness = 100.0f;
+	const FVector FloorLocation(ArenaCenter.X, ArenaCenter.Y, FloorZ - FloorThickness * 0.5f);
+	const FVector FloorScale((ArenaBounds.X * 2.0f + ArenaPadding) / 100.0f, (ArenaBounds.Y * 2.0f + ArenaPadding) / 100.0f, FloorThickness / 100.0f);
+
+	const FTransform FloorTransform(FRotator::ZeroRotator, FloorLocation, FloorScale);
+
+	// Deferred so the mesh is assigned before the static component registers
+	AStaticMeshActor* Floor = GetWorld()->SpawnActorDeferred<AStaticMeshActor>(AStaticMeshActor::StaticClass(), FloorTransform, this);
+	if (Floor)
+	{
+		Floor->GetStaticMeshComponent()->SetStaticMesh(CubeMesh);
+		Floor->FinishSpawning(FloorTransform);
+	}
+}
+
+void ASCharacterManager::SpawnAdditionalAgents(TArray<AActor*>& Agents)
+{
+	UWorld* World = GetWorld();
+	const int32 MaxAgentNum = LearningAgentsManager->GetMaxAgentNum();
+	if (NumAgents > MaxAgentNum)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SCharacterManager: NumAgents %d exceeds manager capacity %d, clamping"), NumAgents, MaxAgentNum);
+	}
+
+	const int32 SpawnNum = FMath::Min(NumAgents, MaxAgentNum) - Agents.Num();
+	if (!World || SpawnNum <= 0)
+	{
+		return;
+	}
+
+	// Prefer the class of the hand-placed agents so spawned ones share their Blueprint setup
+	TSubclassOf<ASCharacter> SpawnClass = AgentClass;
+	if (!SpawnClass)
+	{
+		SpawnClass = Agents.Num() > 0 ? TSubclassOf<ASCharacter>(Agents[0]->GetClass()) : TSubclassOf<ASCharacter>(ASCharacter::StaticClass());
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+	const bool bTrainingPawns = ShouldUseTrainingPawns();
+
+	// Lay the new agents out on a grid around the manager, they are moved by the first episode reset anyway
+	const int32 GridSize = FMath::CeilToInt(FMath::Sqrt((float)SpawnNum));
+	const FVector GridOrigin = GetActorLocation() - FVector(GridSize - 1, GridSize - 1, 0.0f) * (AgentSpawnSpacing * 0.5f);
+
+	Agents.Reserve(Agents.Num() + SpawnNum);
+	for (int32 i = 0; i < SpawnNum; i++)
+	{
+		const FTransform SpawnTransform(GridOrigin + FVector(i % GridSize, i / GridSize, 0.0f) * AgentSpawnSpacing);
+
+		// Deferred so training mode is set before BeginPlay would spawn the weapon
+		ASCharacter* NewAgent = World->SpawnActorDeferred<ASCharacter>(SpawnClass, SpawnTransform, nullptr, nullptr, SpawnParams.SpawnCollisionHandlingOverride);
+		if (NewAgent)
+		{
+			NewAgent->bTrainingMode = bTrainingPawns;
+			NewAgent->FinishSpawning(SpawnTransform);
+			Agents.Add(NewAgent);
+		}
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("SCharacterManager: Spawned %d %s agents (%d total)"), SpawnNum, *SpawnClass->GetName(), Agents.Num());
+}
+
+bool ASCharacterManager::ShouldUseTrainingPawns() const
+{
+	// ReInitialize trains as well, and headless runs only switch to it later in InitializeManager.
+	// Anything that can render keeps the full pawns, stripping the camera and weapon there would be visible
+	return bUseTrainingPawns && !FApp::CanEverRender() && RunMode != ESCharacterManagerMode::Inference;
+}
+
+void ASCharacterManager::ApplyTrainingPawnMode(const TArray<AActor*>& Agents) const
+{
+	if (Agents.Num() == 0)
+	{
+		return;
+	}
+
+	LogAgentBudget(TEXT("full pawn"), Agents);
+
+	for (AActor* Agent : Agents)
+	{
+		// A player's pawn is found with the agents, it keeps its weapon and camera
+		ASCharacter* SChar = Cast<ASCharacter>(Agent);
+		if (SChar && !SChar->IsPlayerControlled())
+		{
+			SChar->EnableTrainingMode();
+		}
+	}
+
+	LogAgentBudget(TEXT("training pawn"), Agents);
+}
+
+void ASCharacterManager::LogAgentBudget(const TCHAR* Label, const TArray<AActor*>& Agents)
+{
+	int32 ComponentNum = 0;
+	int32 TickingNum = 0;
+	int32 ActorNum = 0;
+	SIZE_T ResourceBytes = 0;
+
+	TArray<AActor*> AgentActors;
+	TInlineComponentArray<UActorComponent*> Components;
+	for (AActor* Agent : Agents)
+	{
+		if (!Agent)
+		{
+			continue;
+		}
+
+		// The weapon is spawned as its own actor, count it against the agent that owns it
+		AgentActors.Reset();
+		AgentActors.Add(Agent);
+		Agent->GetAttachedActors(AgentActors, false, true);
+
+		for (AActor* Actor : AgentActors)
+		{
+			if (!IsValid(Actor))
+			{
+				continue;
+			}
+
+			ActorNum++;
+			TickingNum += Actor->IsActorTickEnabled() ? 1 : 0;
+			ResourceBytes += Actor->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+
+			Actor->GetComponents(Components);
+			for (const UActorComponent* Component : Components)
+			{
+				if (IsValid(Component))
+				{
+					ComponentNum++;
+					TickingNum += Component->IsComponentTickEnabled() ? 1 : 0;
+				}
+			}
+		}
+	}
+
+	const float AgentNum = (float)FMath::Max(Agents.Num(), 1);
+	UE_LOG(LogTemp, Log, TEXT("SCharacterManager: Per-agent footprint (%s): %.1f actors, %.1f components, %.1f enabled tick functions, %.1f KB estimated"),
+		Label, ActorNum / AgentNum, ComponentNum / AgentNum, TickingNum / AgentNum, ResourceBytes / AgentNum / 1024.0f);
+}
+
+void ASCharacterManager::SpawnAgentControllers(const TArray<AActor*>& Agents)
+{
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParams.ObjectFlags |= RF_Transient;
+
+	int32 CreatedControllers = 0;
+	int32 FailedControllers = 0;
+	for (AActor* Agent : Agents)
+	{
+		APawn* Pawn = Cast<APawn>(Agent);
+		if (!Pawn || Pawn->GetController())
+		{
+			continue;
+		}
+
+		// Create an AI controller for learning agents
+		AAIController* NewController = World->SpawnActor<AAIController>(AAIController::StaticClass(), FTransform::Identity, SpawnParams);
+		if (NewController)
+		{
+			NewController->Possess(Pawn);
+			CreatedControllers++;
+		}
+		else
+		{
+			UE_LOG(LogTemp, Error, TEXT("SCharacterManager: Failed to create AIController for agent %s"), *Agent->GetName());
+			FailedControllers++;
+		}
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("SCharacterManager: Created %d AIControllers (%d failed, %d agents already controlled)"),
+		CreatedControllers, FailedControllers, Agents.Num() - CreatedControllers - FailedControllers);
+}
+
+void ASCharacterManager::ApplySimulationConfiguration()
+{
+	if (SimulationConfig.SimulationMode == ESCharacterSimulationMode::RealTime)
+	{
+		return;
+	}
+
+	const float StepDeltaTime = FMath::Max(SimulationConfig.FixedStepDeltaTime, 0.001f);
+	int32 StepsPerFrame = FMath::Max(SimulationConfig.StepsPerFrame, 1);
+
+	// Point-mass steps advance the simulator, not the world, so the frame only has to move the world by one step
+	const bool bPointMass = SimulationConfig.SimulationMode == ESCharacterSimulationMode::PointMass;
+
+	// The world clamps undilated frame time, so keep a frame's worth of steps below that limit
+	const AWorldSettings* WorldSettings = GetWorldSettings();
+	if (WorldSettings && !bPointMass)
+	{
+		const int32 MaxStepsPerFrame = FMath::Max(FMath::FloorToInt(WorldSettings->MaxUndilatedFrameTime / StepDeltaTime), 1);
+		if (StepsPerFrame > MaxStepsPerFrame)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("SCharacterManager: SimStepsPerFrame %d exceeds MaxUndilatedFrameTime %f, clamping to %d"),
+				StepsPerFrame, WorldSettings->MaxUndilatedFrameTime, MaxStepsPerFrame);
+			StepsPerFrame = MaxStepsPerFrame;
+		}
+	}
+	SimulationConfig.FixedStepDeltaTime = StepDeltaTime;
+	SimulationConfig.StepsPerFrame = StepsPerFrame;
+
+	// With a fixed time step the engine advances by the simulated delta every frame
+	// and never sleeps to hit FixedFrameRate, so frames run as fast as the CPU allows
+	FApp::SetUseFixedTimeStep(true);
+	FApp::SetFixedDeltaTime(bPointMass ? StepDeltaTime : StepDeltaTime * StepsPerFrame);
+	if (GEngine)
+	{
+		GEngine->bUseFixedFrameRate = false;
+		GEngine->bSmoothFrameRate = false;
+	}
+
+	if (bPointMass)
+	{
+		UE_LOG(LogTemp, Log, TEXT("SCharacterManager: Point-mass simulation runs unthrottled - %d training step(s) of %f s per frame"),
+			StepsPerFrame, StepDeltaTime);
+		return;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("SCharacterManager: Fast-forward simulation enabled - %d training step(s) of %f s per frame"),
+		StepsPerFrame, StepDeltaTime);
+}
+
+void ASCharacterManager::ConfigureAgentSimulation(AActor* Agent) const
+{
+	if (SimulationConfig.SimulationMode == ESCharacterSimulationMode::RealTime)
+	{
+		return;
+	}
+
+	ACharacter* Character = Cast<ACharacter>(Agent);
+	UCharacterMovementComponent* MovementComp = Character ? Character->GetCharacterMovement() : nullptr;
+	if (!MovementComp)
+	{
+		return;
+	}
+
+	// Point-mass agents only keep their pawn as a handle for the manager, nothing needs to move it
+	if (SimulationConfig.SimulationMode == ESCharacterSimulationMode::PointMass)
+	{
+		Character->SetActorTickEnabled(false);
+		MovementComp->SetComponentTickEnabled(false);
+		return;
+	}
+
+	// The manager ticks the movement once per training step instead, always by exactly one fixed step
+	MovementComp->SetComponentTickEnabled(false);
+	MovementComp->MaxSimulationTimeStep = SimulationConfig.FixedStepDeltaTime;
+}
+
 void ASCharacterManager::InitializeManager()
 {
 	UE_LOG(LogTemp, Log, TEXT("SCharacterManager: InitializeManager called with RunMode: %d"), (int32)RunMode);
@@ -408,12 +893,20 @@ void ASCharacterManager::InitializeManager()
 	// Should neural networks be re-initialized
 	const bool ReInitialize = (RunMode == ESCharacterManagerMode::ReInitialize);
 
-	// Make Interactor Instance
+	// Make Interactor Instance, configured before setup since setup specifies the observation schema
 	ULearningAgentsManager* ManagerPtr = LearningAgentsManager;
-	Interactor = Cast<USCharacterInteractor>(ULearningAgentsInteractor::MakeInteractor(
-		ManagerPtr, USCharacterInteractor::StaticClass(), TEXT("SCharacter Interactor")));
-	if (Interactor == nullptr)
+	Interactor = NewObject<USCharacterInteractor>(ManagerPtr, MakeUniqueObjectName(ManagerPtr, USCharacterInteractor::StaticClass(), TEXT("SCharacter Interactor")));
+	Interactor->ObstacleRayNum = ObservationConfig.ObstacleRayNum;
+	Interactor->ObstacleRayLength = ObservationConfig.ObstacleRayLength;
+	Interactor->ObstacleRayFanAngle = ObservationConfig.ObstacleRayFanAngle;
+	Interactor->OccupancyGridSize = ObservationConfig.OccupancyGridSize;
+	Interactor->OccupancyCellSize = ObservationConfig.OccupancyCellSize;
+	Interactor->ObservationHistoryLength = ObservationConfig.ObservationHistoryLength;
+	Interactor->TurnDegreesPerStep = SimulationConfig.TurnDegreesPerStep;
+	Interactor->SetupInteractor(ManagerPtr);
+	if (!Interactor->IsSetup())
 	{
+		Interactor = nullptr;
 		UE_LOG(LogTemp, Warning, TEXT("SCharacterManager: Failed to make interactor object."));
 		return;
 	}
@@ -460,6 +953,10 @@ void ASCharacterManager::InitializeManager()
 		return;
 	}
 	TrainingEnvironment->TargetActor = TargetActor;
+	TrainingEnvironment->ObstacleRandomSeed = RandomSeed;
+	TrainingEnvironment->DecisionInterval = FMath::Max(DecisionInterval, 1);
+	UE_CLOG(DecisionInterval > 1, LogTemp, Log, TEXT("SCharacterManager: Decisions held for %d steps, episodes end after %d decisions (%s simulation steps)"),
+		DecisionInterval, TrainingEnvironment->GetMaxEpisodeDecisions(), *FString::SanitizeFloat(TrainingEnvironment->MaxEpisodeLength));
 	
 	// Configure obstacles from command line parameters
 	TrainingEnvironment->ConfigureObstacles(
@@ -467,10 +964,45 @@ void ASCharacterManager::InitializeManager()
 		ObstacleConfig.MaxObstacles,
 		ObstacleConfig.MinObstacleSize,
 		ObstacleConfig.MaxObstacleSize,
-		ObstacleConfig.ObstacleMode
+		ObstacleConfig.ObstacleMode,
+		ObstacleConfig.bUseInstancedObstacles
 	);
+
+	if (!ObstacleConfig.LayoutLibraryPath.IsEmpty())
+	{
+		const FString LayoutLibraryFile = FPaths::IsRelative(ObstacleConfig.LayoutLibraryPath)
+			? FPaths::Combine(FPaths::ProjectDir(), ObstacleConfig.LayoutLibraryPath)
+			: ObstacleConfig.LayoutLibraryPath;
+		if (!TrainingEnvironment->SetObstacleLayoutLibrary(LayoutLibraryFile))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("SCharacterManager: Could not open obstacle layout library %s, sampling layouts instead"), *LayoutLibraryFile);
+		}
+	}
 	TrainingEnvironmentBase = TrainingEnvironment;
 
+	// Point-mass agents each get their own copy of the reset region inside the simulator
+	if (SimulationConfig.SimulationMode == ESCharacterSimulationMode::PointMass)
+	{
+		// The simulator turns exactly as far as the pawns do
+		FSCharacterPointMassSimSettings SimSettings = TrainingEnvironment->MakePointMassSimSettings();
+		SimSettings.TurnDegreesPerStep = SimulationConfig.TurnDegreesPerStep;
+
+		// Sized to the agents registered above rather than the manager's capacity, so unused slots get no arena
+		int32 AgentSlotNum = 0;
+		for (const int32 AgentId : ManagedAgentIds)
+		{
+			AgentSlotNum = FMath::Max(AgentSlotNum, AgentId + 1);
+		}
+		LearningAgentsManager->StartPointMassSim(SimSettings, AgentSlotNum, RandomSeed);
+		UE_LOG(LogTemp, Log, TEXT("SCharacterManager: Point-mass simulation enabled - %d agent(s) in %d slot(s), %d step(s) of %f s per frame"),
+			ManagedAgentIds.Num(), AgentSlotNum, SimulationConfig.StepsPerFrame, SimulationConfig.FixedStepDeltaTime);
+	}
+	else
+	{
+		// Tile the reset region now that its center and bounds are known
+		InitializeArenas();
+	}
+
 	// Create a shared memory communicator to spawn a training process (following car example)
 	FLearningAgentsCommunicator Communicator = ULearningAgentsCommunicatorLibrary::MakeSharedMemoryTrainingProcess(
 		TrainerProcessSettings, SharedMemorySettings
@@ -489,24 +1021,166 @@ void ASCharacterManager::InitializeManager()
 	UE_LOG(LogTemp, Log, TEXT("SCharacterManager: Initialization complete. Mode: %d"), (int32)RunMode);
 }
 
+void ASCharacterManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// An in-flight evaluation still uses the policy, finish it before anything is torn down
+	if (LearningAgentsManager != nullptr)
+	{
+		LearningAgentsManager->WaitForInference();
+		LearningAgentsManager->SetInferenceTask(UE::Tasks::FTask());
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void ASCharacterManager::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
-	// Handle different run modes like in car example
-	if (RunMode == ESCharacterManagerMode::Inference)
+	// Wall time between manager ticks covers the whole engine frame, including movement and physics
+	const double NowSeconds = FPlatformTime::Seconds();
+	if (LastTickSeconds > 0.0)
+	{
+		FSCharacterTrainingStats::Get().RecordStageTime(ESCharacterTrainingStage::Frame, NowSeconds - LastTickSeconds);
+	}
+	LastTickSeconds = NowSeconds;
+
+	// The point-mass simulator runs several full training steps per frame, advancing between them
+	if (FSCharacterPointMassSim* Sim = LearningAgentsManager ? LearningAgentsManager->GetPointMassSim() : nullptr)
+	{
+		const float StepDeltaTime = FMath::Max(SimulationConfig.FixedStepDeltaTime, 0.001f);
+		for (int32 Step = 0; Step < FMath::Max(SimulationConfig.StepsPerFrame, 1); Step++)
+		{
+			RunAgentStep();
+
+			SCOPE_COOP_TRAINING_STAGE(SimStep);
+			Sim->Step(StepDeltaTime);
+		}
+
+		FlushTrainingStats();
+		return;
+	}
+
+	if (SimulationConfig.SimulationMode == ESCharacterSimulationMode::FastForward)
+	{
+		RunFastForwardSteps();
+	}
+	else
+	{
+		RunAgentStep();
+	}
+
+	FlushTrainingStats();
+}
+
+void ASCharacterManager::RunFastForwardSteps()
+{
+	FastForwardMovement.Reset();
+	for (const int32 AgentId : ManagedAgentIds)
+	{
+		const ACharacter* Character = Cast<ACharacter>(LearningAgentsManager->GetAgent(AgentId, ACharacter::StaticClass()));
+		if (UCharacterMovementComponent* MovementComp = Character ? Character->GetCharacterMovement() : nullptr)
+		{
+			FastForwardMovement.Add(MovementComp);
+		}
+	}
+
+	// Each step acts on the observations of the previous one, and the movement consumes that step's input right away
+	const float StepDeltaTime = FMath::Max(SimulationConfig.FixedStepDeltaTime, 0.001f);
+	for (int32 Step = 0; Step < FMath::Max(SimulationConfig.StepsPerFrame, 1); Step++)
 	{
-		if (Policy != nullptr)
+		RunAgentStep();
+
+		SCOPE_COOP_TRAINING_STAGE(SimStep);
+		for (UCharacterMovementComponent* MovementComp : FastForwardMovement)
 		{
-			Policy->RunInference();
+			MovementComp->TickComponent(StepDeltaTime, LEVELTICK_All, &MovementComp->PrimaryComponentTick);
 		}
 	}
-	else // Training or ReInitialize mode
+}
+
+void ASCharacterManager::RunAgentStep()
+{
+	SCOPE_COOP_TRAINING_STAGE(TrainingStep);
+
+	// Rewards and completions of this step share one environment snapshot
+	if (TrainingEnvironment != nullptr)
 	{
-		if (PPOTrainer != nullptr)
+		TrainingEnvironment->BeginStep();
+	}
+
+	// Between decisions the agents keep their last action and training banks the rewards it earns
+	if (StepsUntilDecision > 0)
+	{
+		StepsUntilDecision--;
+		if (Interactor != nullptr)
 		{
-			PPOTrainer->RunTraining(TrainingSettings, TrainingGameSettings, true, true);
-			
+			Interactor->ApplyHeldActions(ManagedAgentIds);
 		}
+		if (RunMode != ESCharacterManagerMode::Inference && TrainingEnvironment != nullptr)
+		{
+			TrainingEnvironment->AccumulateHeldRewards(ManagedAgentIds);
+		}
+		return;
 	}
+	StepsUntilDecision = FMath::Max(DecisionInterval, 1) - 1;
+
+	// Handle different run modes like in car example
+	if (RunMode == ESCharacterManagerMode::Inference)
+	{
+		RunPolicyInference();
+	}
+	else if (PPOTrainer != nullptr) // Training or ReInitialize mode
+	{
+		PPOTrainer->RunTraining(TrainingSettings, TrainingGameSettings, true, true);
+	}
+}
+
+void ASCharacterManager::RunPolicyInference()
+{
+	if (Policy == nullptr)
+	{
+		return;
+	}
+
+	if (InferenceLatency <= 0 || LearningAgentsInteractorBase == nullptr || LearningAgentsManager == nullptr)
+	{
+		Policy->RunInference();
+		return;
+	}
+
+	// Apply the actions evaluated from the previous decision's observations. The task normally finished while the
+	// world simulated, waiting here is the fallback that keeps a slow evaluation from ever skipping a decision
+	if (LearningAgentsManager->WaitForInference())
+	{
+		LearningAgentsInteractorBase->PerformActions();
+	}
+
+	// Until the next decision waits on it the task is the only user of the agent set and of the interactor's and
+	// policy's buffers: held steps replay the interactor's own copy of the last actions, inference mode gathers no
+	// rewards or completions, and agents are only added or removed after waiting on the task
+	LearningAgentsInteractorBase->GatherObservations();
+	ULearningAgentsPolicy* EvaluatedPolicy = Policy;
+	LearningAgentsManager->SetInferenceTask(UE::Tasks::Launch(UE_SOURCE_LOCATION, [EvaluatedPolicy]()
+	{
+		// Keeps garbage collection from running while the worker is inside a UObject, as async loading does
+		FGCScopeGuard GCGuard;
+		EvaluatedPolicy->EvaluatePolicy();
+	}));
+}
+
+void ASCharacterManager::FlushTrainingStats()
+{
+	// One trainer iteration records at most this many steps, so summarize at about that rate. Counted from the steps run
+	// rather than the rewards recorded, which inference never gathers
+	FSCharacterTrainingStats& Stats = FSCharacterTrainingStats::Get();
+	const int64 AgentStepsRun = (int64)Stats.GetStageCalls(ESCharacterTrainingStage::TrainingStep) * FMath::Max(ManagedAgentIds.Num(), 1);
+	if (AgentStepsRun < FMath::Max(TrainerSettings.MaximumRecordedStepsPerIteration, 1))
+	{
+		return;
+	}
+
+	TrainingStatsIteration++;
+	UE_LOG(LogTemp, Log, TEXT("SCharacterManager: Iteration %d | %s"), TrainingStatsIteration, *Stats.ToSummaryString());
+	Stats.Reset();
 }
\ No newline at end of file
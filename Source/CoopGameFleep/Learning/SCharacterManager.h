@@ -18,7 +18,9 @@ class USCharacterInteractor;
 class USCharacterTrainingEnvironment;
 class ASTargetActor;
 class ULearningAgentsNeuralNetwork;
+class UCharacterMovementComponent;
 class USObstacleManager;
+class ASCharacter;
 
 
 UENUM(BlueprintType)
@@ -29,6 +31,14 @@ enum class ESCharacterManagerMode : uint8
 	ReInitialize	UMETA(DisplayName = "ReInitialize")
 };
 
+UENUM(BlueprintType)
+enum class ESCharacterSimulationMode : uint8
+{
+	RealTime		UMETA(DisplayName = "Real Time"),
+	FastForward		UMETA(DisplayName = "Fast Forward"),
+	PointMass		UMETA(DisplayName = "Point Mass")
+};
+
 
 USTRUCT(BlueprintType)
 struct FObstacleConfiguration
@@ -49,6 +59,65 @@ struct FObstacleConfiguration
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Obstacles")
 	EObstacleMode ObstacleMode = EObstacleMode::Static;
+
+	// One instanced mesh per arena instead of one actor per obstacle
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Obstacles")
+	bool bUseInstancedObstacles = false;
+
+	// Pre-generated layout library written by the SObstacleLayout commandlet, relative to the project directory
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Obstacles")
+	FString LayoutLibraryPath;
+};
+
+USTRUCT(BlueprintType)
+struct FObservationConfiguration
+{
+	GENERATED_BODY()
+
+	// Obstacle distance rays fanned around each agent's facing, 0 leaves them out of the observation
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Observations", meta = (ClampMin = 0))
+	int32 ObstacleRayNum = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Observations", meta = (ClampMin = 1))
+	float ObstacleRayLength = 1000.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Observations", meta = (ClampMin = 0, ClampMax = 360))
+	float ObstacleRayFanAngle = 360.0f;
+
+	// Cells per side of the agent-centered obstacle occupancy grid, 0 leaves it out of the observation
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Observations", meta = (ClampMin = 0, ClampMax = 64))
+	int32 OccupancyGridSize = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Observations", meta = (ClampMin = 1))
+	float OccupancyCellSize = 50.0f;
+
+	// Previous observations stacked into each agent's observation, 0 leaves them out
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Observations", meta = (ClampMin = 0, ClampMax = 16))
+	int32 ObservationHistoryLength = 0;
+};
+
+USTRUCT(BlueprintType)
+struct FSimulationConfiguration
+{
+	GENERATED_BODY()
+
+	// RealTime follows the engine frame pacing, FastForward runs unthrottled with a fixed simulated delta,
+	// PointMass moves the agents in the engine-free simulator for pretraining, their pawns are still needed as the agent handles
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Simulation")
+	ESCharacterSimulationMode SimulationMode = ESCharacterSimulationMode::RealTime;
+
+	// Simulated time advanced by a single fixed-size step in fast-forward and point-mass modes
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Simulation", meta = (ClampMin = 0.001))
+	float FixedStepDeltaTime = 1.0f / 60.0f;
+
+	// Full training steps per engine frame in fast-forward and point-mass modes, each advancing the agents by one fixed
+	// step and recording a sample
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Simulation", meta = (ClampMin = 1))
+	int32 StepsPerFrame = 1;
+
+	// Yaw change for a full turn action on the pawns and in the point-mass simulator, 0 keeps the turn action a no-op
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Simulation", meta = (ClampMin = 0))
+	float TurnDegreesPerStep = 0.0f;
 };
 
 /**
@@ -64,6 +133,7 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	// Core learning components
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Components")
@@ -94,6 +164,61 @@ protected:
 	void InitializeAgents();
 	void InitializeManager();
 
+	// Replicate the training environment's reset region into NumArenas tiles and assign agents to them
+	void InitializeArenas();
+
+	// Spawn a floor slab under an arena that has no level geometry
+	void SpawnArenaFloor(const FVector& ArenaCenter, const FVector& ArenaBounds, float FloorZ);
+
+	// Ids of all agents added to the manager
+	TArray<int32> ManagedAgentIds;
+
+	// Spawn agents until NumAgents are present in the world
+	void SpawnAdditionalAgents(TArray<AActor*>& Agents);
+
+	// Spawn AI controllers for every agent that does not have one yet
+	void SpawnAgentControllers(const TArray<AActor*>& Agents);
+
+	// Switch the engine to an unthrottled fixed time step in fast-forward and point-mass modes
+	void ApplySimulationConfiguration();
+
+	// Whether agents should be stripped down to training-only pawns
+	bool ShouldUseTrainingPawns() const;
+
+	// Switch the hand-placed agents to training pawns and log their per-agent footprint before and after
+	void ApplyTrainingPawnMode(const TArray<AActor*>& Agents) const;
+
+	// Log average actor, component and enabled tick function counts and estimated resource size of the given agents,
+	// including attached actors. Counts only, no tick time is measured
+	static void LogAgentBudget(const TCHAR* Label, const TArray<AActor*>& Agents);
+
+	// Log and clear the training event counters once an iteration's worth of agent-steps was run, in training and inference alike
+	void FlushTrainingStats();
+
+	// Summaries emitted so far
+	int32 TrainingStatsIteration = 0;
+
+	// Platform time of the previous Tick, for frame timing
+	double LastTickSeconds = 0.0;
+
+	// Query the policy, or hold its last action for the steps between decisions
+	void RunAgentStep();
+
+	// Simulation steps left before the policy is queried again
+	int32 StepsUntilDecision = 0;
+
+	// One inference decision, evaluated on a worker task when InferenceLatency is 1
+	void RunPolicyInference();
+
+	// Make the agent's movement integrate in fixed-size steps matching the simulation configuration
+	void ConfigureAgentSimulation(AActor* Agent) const;
+
+	// Fast-forward frame: StepsPerFrame training steps, each followed by one fixed step of every agent's movement
+	void RunFastForwardSteps();
+
+	// Movement components advanced by hand in fast-forward mode, refreshed every frame
+	TArray<UCharacterMovementComponent*> FastForwardMovement;
+
 public:	
 	virtual void Tick(float DeltaTime) override;
 
@@ -104,6 +229,45 @@ public:
 	UPROPERTY(EditAnywhere, Category = "Manager Settings")
 	int32 RandomSeed = 1234;
 
+	// Decisions between gathering observations and applying the resulting actions in Inference mode.
+	// 0 evaluates the policy on the game thread, 1 evaluates it on a worker task while the world simulates
+	UPROPERTY(EditAnywhere, Category = "Manager Settings", meta = (ClampMin = 0, ClampMax = 1))
+	int32 InferenceLatency = 0;
+
+	// Total agents to run, hand-placed agents count towards it (0 = only use hand-placed agents)
+	UPROPERTY(EditAnywhere, Category = "Manager Settings", meta = (ClampMin = 0))
+	int32 NumAgents = 0;
+
+	// Class spawned for additional agents, defaults to the class of the hand-placed agents
+	UPROPERTY(EditAnywhere, Category = "Manager Settings")
+	TSubclassOf<ASCharacter> AgentClass;
+
+	// Distance between spawned agents before their first episode reset
+	UPROPERTY(EditAnywhere, Category = "Manager Settings")
+	float AgentSpawnSpacing = 200.0f;
+
+	// Run agents as training-only pawns (no weapon, camera or actor tick) while training headless.
+	// Ignored when the engine can render, such as editor or PIE training, and never applied to player-controlled pawns
+	UPROPERTY(EditAnywhere, Category = "Manager Settings")
+	bool bUseTrainingPawns = true;
+
+	// Number of arena tiles, each with its own target and obstacles (agents are assigned round-robin)
+	UPROPERTY(EditAnywhere, Category = "Arenas", meta = (ClampMin = 1))
+	int32 NumArenas = 1;
+
+	// Gap between neighbouring arena tiles
+	UPROPERTY(EditAnywhere, Category = "Arenas")
+	float ArenaPadding = 1000.0f;
+
+	// Spawn a floor under every tile other than the first, which uses the level's geometry
+	UPROPERTY(EditAnywhere, Category = "Arenas")
+	bool bSpawnArenaFloors = true;
+
+	// Give every agent its own copy of its arena's target, so an agent resetting never moves an arena-mate's goal.
+	// Off, an arena's agents share its target and it moves when the arena's first agent resets
+	UPROPERTY(EditAnywhere, Category = "Arenas")
+	bool bPerAgentTargets = false;
+
 
 	// Learning settings
 	UPROPERTY(EditAnywhere, Category = "Learning Settings")
@@ -118,6 +282,10 @@ public:
 	UPROPERTY(EditAnywhere, Category = "Learning Settings")
 	FLearningAgentsTrainingGameSettings TrainingGameSettings;
 
+	// Simulation steps each policy decision is held for, the held steps' rewards are summed into the decision's sample
+	UPROPERTY(EditAnywhere, Category = "Learning Settings", meta = (ClampMin = 1))
+	int32 DecisionInterval = 1;
+
 	// Neural network references
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Neural Networks")
 	ULearningAgentsNeuralNetwork* EncoderNeuralNetwork;
@@ -148,4 +316,12 @@ public:
 	// Obstacle configuration
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Obstacles")
 	FObstacleConfiguration ObstacleConfig;
+
+	// Optional observation features, fixed once the interactor has specified its schema
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Observations")
+	FObservationConfiguration ObservationConfig;
+
+	// Simulation stepping configuration
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Simulation")
+	FSimulationConfiguration SimulationConfig;
 }; 
\ No newline at end of file
@@ -7,8 +7,101 @@ USCharacterManagerComponent::USCharacterManagerComponent()
 	PrimaryComponentTick.bCanEverTick = false;
 }
 
+int32 USCharacterManagerComponent::GetRequestedAgentNum()
+{
+	int32 RequestedAgentNum = 0;
+	FParse::Value(FCommandLine::Get(), TEXT("-NumAgents="), RequestedAgentNum);
+	return FMath::Max(RequestedAgentNum, 0);
+}
+
 void USCharacterManagerComponent::PostInitProperties()
 {
-	MaxAgentNum = 32; // Set maximum number of agents this manager can handle
+	// Set maximum number of agents this manager can handle, grown to fit -NumAgents= before the manager allocates
+	MaxAgentNum = FMath::Max(DefaultMaxAgentNum, GetRequestedAgentNum());
 	Super::PostInitProperties();
-} 
\ No newline at end of file
+}
+
+void USCharacterManagerComponent::SetArenas(const TArray<FSCharacterArena>& NewArenas, const TArray<int32>& AgentIds)
+{
+	Arenas = NewArenas;
+	for (FSCharacterArena& Arena : Arenas)
+	{
+		Arena.AgentIds.Reset();
+	}
+	AgentArenaIndices.Init(INDEX_NONE, GetMaxAgentNum());
+	AgentTargets.Init(nullptr, GetMaxAgentNum());
+
+	if (Arenas.Num() == 0)
+	{
+		return;
+	}
+
+	for (int32 i = 0; i < AgentIds.Num(); i++)
+	{
+		const int32 AgentId = AgentIds[i];
+		if (!AgentArenaIndices.IsValidIndex(AgentId))
+		{
+			continue;
+		}
+
+		const int32 ArenaIndex = i % Arenas.Num();
+		AgentArenaIndices[AgentId] = ArenaIndex;
+		AgentTargets[AgentId] = Arenas[ArenaIndex].TargetActor;
+		Arenas[ArenaIndex].AgentIds.Add(AgentId);
+	}
+}
+
+void USCharacterManagerComponent::SetAgentTarget(const int32 AgentId, ASTargetActor* Target)
+{
+	if (AgentTargets.IsValidIndex(AgentId))
+	{
+		AgentTargets[AgentId] = Target;
+	}
+}
+
+FSCharacterArena* USCharacterManagerComponent::GetAgentArena(const int32 AgentId)
+{
+	const int32 ArenaIndex = GetAgentArenaIndex(AgentId);
+	return ArenaIndex != INDEX_NONE ? &Arenas[ArenaIndex] : nullptr;
+}
+
+const FSCharacterArena* USCharacterManagerComponent::GetAgentArena(const int32 AgentId) const
+{
+	const int32 ArenaIndex = GetAgentArenaIndex(AgentId);
+	return ArenaIndex != INDEX_NONE ? &Arenas[ArenaIndex] : nullptr;
+}
+
+const USObstacleManager* USCharacterManagerComponent::GetAgentObstacleManager(const int32 AgentId) const
+{
+	const FSCharacterArena* Arena = GetAgentArena(AgentId);
+	return Arena ? Arena->ObstacleManager : DefaultObstacleManager;
+}
+
+void USCharacterManagerComponent::StartPointMassSim(const FSCharacterPointMassSimSettings& Settings, const int32 AgentSlotNum, const int32 Seed)
+{
+	PointMassSim = MakeUnique<FSCharacterPointMassSim>();
+	PointMassSim->Initialize(Settings, FMath::Min(AgentSlotNum, GetMaxAgentNum()), Seed);
+}
+
+bool USCharacterManagerComponent::WaitForInference()
+{
+	if (!InferenceTask.IsValid())
+	{
+		return false;
+	}
+
+	InferenceTask.Wait();
+	return true;
+}
+
+int32 USCharacterManagerComponent::AddAgentAfterInference(UObject* Agent)
+{
+	WaitForInference();
+	return AddAgent(Agent);
+}
+
+void USCharacterManagerComponent::RemoveAgentAfterInference(const int32 AgentId)
+{
+	WaitForInference();
+	RemoveAgent(AgentId);
+}
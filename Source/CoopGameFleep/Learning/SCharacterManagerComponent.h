@@ -4,8 +4,42 @@
 
 #include "CoreMinimal.h"
 #include "LearningAgentsManager.h"
+#include "Learning/SCharacterPointMassSim.h"
+#include "Tasks/Task.h"
 #include "SCharacterManagerComponent.generated.h"
 
+class ASTargetActor;
+class USObstacleManager;
+
+/**
+ * One tile of the training world with its own target and obstacle set
+ */
+USTRUCT(BlueprintType)
+struct FSCharacterArena
+{
+	GENERATED_BODY()
+
+	// World-space center of this arena's reset region
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Arena")
+	FVector Center = FVector::ZeroVector;
+
+	// Target shared by the arena's agents, only the first agent's with per-agent targets, where it is the template for the others
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Arena")
+	ASTargetActor* TargetActor = nullptr;
+
+	// Created on demand by the training environment when obstacles are enabled
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Arena")
+	USObstacleManager* ObstacleManager = nullptr;
+
+	// Agents assigned to this arena
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Arena")
+	TArray<int32> AgentIds;
+
+	// Sits on the level's own reset region, the only arena that may use its LocationVolume
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Arena")
+	bool bIsPrimary = false;
+};
+
 /**
  * Manager component for SCharacter learning agents
  */
@@ -17,6 +51,82 @@ class COOPGAMEFLEEP_API USCharacterManagerComponent : public ULearningAgentsMana
 public:
 	USCharacterManagerComponent();
 
+	// Capacity used when no larger agent count is requested on the command line
+	static constexpr int32 DefaultMaxAgentNum = 32;
+
+	// Agent count requested with -NumAgents=, or 0 when not set
+	static int32 GetRequestedAgentNum();
+
+	// Replace the arena layout and distribute the given agents over it round-robin
+	void SetArenas(const TArray<FSCharacterArena>& NewArenas, const TArray<int32>& AgentIds);
+
+	int32 GetArenaNum() const { return Arenas.Num(); }
+
+	FSCharacterArena& GetArena(const int32 ArenaIndex) { return Arenas[ArenaIndex]; }
+	const FSCharacterArena& GetArena(const int32 ArenaIndex) const { return Arenas[ArenaIndex]; }
+
+	// Arena index of the agent, or INDEX_NONE when no arenas are set up
+	int32 GetAgentArenaIndex(const int32 AgentId) const
+	{
+		return AgentArenaIndices.IsValidIndex(AgentId) ? AgentArenaIndices[AgentId] : INDEX_NONE;
+	}
+
+	// Arena of the agent, or nullptr when no arenas are set up
+	FSCharacterArena* GetAgentArena(const int32 AgentId);
+	const FSCharacterArena* GetAgentArena(const int32 AgentId) const;
+
+	// Target the agent chases, its own one inside its arena, or nullptr when no arenas are set up
+	ASTargetActor* GetAgentTarget(const int32 AgentId) const
+	{
+		return AgentTargets.IsValidIndex(AgentId) ? AgentTargets[AgentId] : nullptr;
+	}
+
+	// Give the agent its own target, so resetting it never moves the goal of an arena-mate mid-episode
+	void SetAgentTarget(const int32 AgentId, ASTargetActor* Target);
+
+	// Obstacle manager the agent collides with, the arena's own or the shared one when no arenas are set up
+	const USObstacleManager* GetAgentObstacleManager(const int32 AgentId) const;
+
+	// Obstacles shared by every agent when no arenas are set up, registered by the training environment
+	void SetDefaultObstacleManager(USObstacleManager* InObstacleManager) { DefaultObstacleManager = InObstacleManager; }
+
+	// Back every agent with the engine-free simulator instead of its pawn. The pawns stay registered as the agents' handles,
+	// the simulator holds AgentSlotNum agents indexed by AgentId, so it must exceed every registered AgentId
+	void StartPointMassSim(const FSCharacterPointMassSimSettings& Settings, const int32 AgentSlotNum, const int32 Seed);
+
+	// Simulator driving the agents, or nullptr when they run in the world
+	FSCharacterPointMassSim* GetPointMassSim() const { return PointMassSim.Get(); }
+
+	// Policy evaluation on a worker task, which has the agent set and the interactor's and policy's buffers to itself
+	// until it completes
+	void SetInferenceTask(const UE::Tasks::FTask& Task) { InferenceTask = Task; }
+
+	bool IsInferenceInFlight() const { return InferenceTask.IsValid() && !InferenceTask.IsCompleted(); }
+
+	// Block until the evaluation completes, false when none was launched since the last decision
+	bool WaitForInference();
+
+	// Change the agent set only once no evaluation is reading it, the evaluated actions stay pending for the next decision
+	int32 AddAgentAfterInference(UObject* Agent);
+	void RemoveAgentAfterInference(const int32 AgentId);
+
 protected:
 	virtual void PostInitProperties() override;
-}; 
\ No newline at end of file
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Arenas")
+	TArray<FSCharacterArena> Arenas;
+
+	UPROPERTY()
+	USObstacleManager* DefaultObstacleManager = nullptr;
+
+	// Arena index per AgentId, INDEX_NONE for unassigned ids
+	TArray<int32> AgentArenaIndices;
+
+	// Target per AgentId, the arena's target until the agent is given its own
+	UPROPERTY()
+	TArray<ASTargetActor*> AgentTargets;
+
+	TUniquePtr<FSCharacterPointMassSim> PointMassSim;
+
+	UE::Tasks::FTask InferenceTask;
+};
@@ -0,0 +1,346 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Learning/SCharacterPointMassSim.h"
+
+void FSCharacterPointMassSim::Initialize(const FSCharacterPointMassSimSettings& InSettings, const int32 InAgentNum, const int32 Seed)
+{
+	Settings = InSettings;
+	Settings.MaxObstacles = FMath::Max(Settings.MaxObstacles, 0);
+	AgentNum = FMath::Max(InAgentNum, 0);
+	Random.Initialize(Seed);
+
+	// Same height the environment resets characters and targets to
+	Height = Settings.ArenaCenter.Z + FMath::Max(Settings.ArenaBounds.Z, 100.0f);
+
+	PositionX.SetNumZeroed(AgentNum);
+	PositionY.SetNumZeroed(AgentNum);
+	VelocityX.SetNumZeroed(AgentNum);
+	VelocityY.SetNumZeroed(AgentNum);
+	Yaw.SetNumZeroed(AgentNum);
+	TargetX.SetNumZeroed(AgentNum);
+	TargetY.SetNumZeroed(AgentNum);
+	ActionForward.SetNumZeroed(AgentNum);
+	ActionRight.SetNumZeroed(AgentNum);
+	ActionTurn.SetNumZeroed(AgentNum);
+	PreviousDistances.Init(-1.0f, AgentNum);
+	EpisodeSteps.SetNumZeroed(AgentNum);
+	Obstacles.Init(FBox2f(ForceInit), AgentNum * Settings.MaxObstacles);
+
+	for (int32 AgentId = 0; AgentId < AgentNum; AgentId++)
+	{
+		// Static layouts are generated once per agent, like the obstacle manager does per arena
+		if (!Settings.bRegenerateObstaclesOnReset)
+		{
+			GenerateObstacles(AgentId, false);
+		}
+
+		ResetAgent(AgentId);
+	}
+}
+
+void FSCharacterPointMassSim::ResetAgent(const int32 AgentId)
+{
+	check(AgentId >= 0 && AgentId < AgentNum);
+
+	VelocityX[AgentId] = 0.0f;
+	VelocityY[AgentId] = 0.0f;
+	Yaw[AgentId] = 0.0f;
+	ActionForward[AgentId] = 0.0f;
+	ActionRight[AgentId] = 0.0f;
+	ActionTurn[AgentId] = 0.0f;
+	PreviousDistances[AgentId] = -1.0f;
+	EpisodeSteps[AgentId] = 0;
+
+	// Same rejection sampling and attempt limits as USCharacterTrainingEnvironment::ResetAgentEpisode
+	FVector2f Position;
+	int32 Attempts = 0;
+	do
+	{
+		Position = SamplePoint();
+		Attempts++;
+	} while (IsBlocked(AgentId, Position.X, Position.Y, Settings.BlockedCheckRadius) && Attempts < 50);
+
+	FVector2f Target;
+	Attempts = 0;
+	do
+	{
+		Target = SamplePoint();
+		Attempts++;
+	} while ((FVector2f::Distance(Position, Target) < Settings.MinDistanceBetweenCharacterAndTarget ||
+		IsBlocked(AgentId, Target.X, Target.Y, Settings.BlockedCheckRadius)) && Attempts < 100);
+
+	PositionX[AgentId] = Position.X;
+	PositionY[AgentId] = Position.Y;
+	TargetX[AgentId] = Target.X;
+	TargetY[AgentId] = Target.Y;
+
+	if (Settings.bRegenerateObstaclesOnReset)
+	{
+		GenerateObstacles(AgentId, true);
+	}
+}
+
+void FSCharacterPointMassSim::SetAction(const int32 AgentId, const float MoveForward, const float MoveRight, const float Turn)
+{
+	ActionForward[AgentId] = FMath::Clamp(MoveForward, -1.0f, 1.0f);
+	ActionRight[AgentId] = FMath::Clamp(MoveRight, -1.0f, 1.0f);
+	ActionTurn[AgentId] = FMath::Clamp(Turn, -1.0f, 1.0f);
+}
+
+void FSCharacterPointMassSim::Step(const float DeltaTime)
+{
+	const float FrictionAlpha = FMath::Min(DeltaTime * Settings.GroundFriction, 1.0f);
+	const float BrakingFriction = Settings.GroundFriction * Settings.BrakingFrictionFactor;
+
+	for (int32 AgentId = 0; AgentId < AgentNum; AgentId++)
+	{
+		// Turn first, movement input is relative to the facing like AddMovementInput on the actor axes
+		if (FMath::Abs(ActionTurn[AgentId]) > 0.01f)
+		{
+			Yaw[AgentId] = FMath::UnwindDegrees(Yaw[AgentId] + ActionTurn[AgentId] * Settings.TurnDegreesPerStep);
+		}
+
+		float SinYaw, CosYaw;
+		FMath::SinCos(&SinYaw, &CosYaw, FMath::DegreesToRadians(Yaw[AgentId]));
+
+		// Forward is (cos, sin), right is (-sin, cos), input is clamped to unit length like ConsumeInputVector
+		float InputX = ActionForward[AgentId] * CosYaw - ActionRight[AgentId] * SinYaw;
+		float InputY = ActionForward[AgentId] * SinYaw + ActionRight[AgentId] * CosYaw;
+		const float InputSize = FMath::Min(FMath::Sqrt(InputX * InputX + InputY * InputY), 1.0f);
+
+		float VelX = VelocityX[AgentId];
+		float VelY = VelocityY[AgentId];
+		const float Speed = FMath::Sqrt(VelX * VelX + VelY * VelY);
+
+		if (InputSize > UE_KINDA_SMALL_NUMBER)
+		{
+			const float InvInput = 1.0f / FMath::Sqrt(InputX * InputX + InputY * InputY);
+			InputX *= InvInput;
+			InputY *= InvInput;
+
+			// UCharacterMovementComponent::CalcVelocity: friction steers velocity towards the input direction
+			VelX -= (VelX - InputX * Speed) * FrictionAlpha;
+			VelY -= (VelY - InputY * Speed) * FrictionAlpha;
+			VelX += InputX * InputSize * Settings.MaxAcceleration * DeltaTime;
+			VelY += InputY * InputSize * Settings.MaxAcceleration * DeltaTime;
+
+			const float MaxInputSpeed = Settings.MaxSpeed * InputSize;
+			const float NewSpeed = FMath::Sqrt(VelX * VelX + VelY * VelY);
+			if (NewSpeed > MaxInputSpeed)
+			{
+				const float Scale = MaxInputSpeed / NewSpeed;
+				VelX *= Scale;
+				VelY *= Scale;
+			}
+		}
+		else if (Speed > UE_KINDA_SMALL_NUMBER)
+		{
+			// ApplyVelocityBraking: constant deceleration plus friction, stopping instead of reversing
+			const float OldVelX = VelX;
+			const float OldVelY = VelY;
+			VelX += (-BrakingFriction * VelX - VelX / Speed * Settings.BrakingDeceleration) * DeltaTime;
+			VelY += (-BrakingFriction * VelY - VelY / Speed * Settings.BrakingDeceleration) * DeltaTime;
+			if (VelX * OldVelX + VelY * OldVelY <= 0.0f)
+			{
+				VelX = 0.0f;
+				VelY = 0.0f;
+			}
+		}
+
+		// Move, sliding along obstacle faces one axis at a time
+		float X = PositionX[AgentId];
+		float Y = PositionY[AgentId];
+		const float NewX = X + VelX * DeltaTime;
+		const float NewY = Y + VelY * DeltaTime;
+
+		if (!IsBlocked(AgentId, NewX, NewY, Settings.CapsuleRadius))
+		{
+			X = NewX;
+			Y = NewY;
+		}
+		else
+		{
+			if (!IsBlocked(AgentId, NewX, Y, Settings.CapsuleRadius))
+			{
+				X = NewX;
+			}
+			else
+			{
+				VelX = 0.0f;
+			}
+
+			if (!IsBlocked(AgentId, X, NewY, Settings.CapsuleRadius))
+			{
+				Y = NewY;
+			}
+			else
+			{
+				VelY = 0.0f;
+			}
+		}
+
+		PositionX[AgentId] = X;
+		PositionY[AgentId] = Y;
+		VelocityX[AgentId] = VelX;
+		VelocityY[AgentId] = VelY;
+	}
+}
+
+void FSCharacterPointMassSim::Evaluate(TArrayView<float> OutRewards, TArrayView<bool> OutCompleted)
+{
+	check(OutRewards.Num() >= AgentNum && OutCompleted.Num() >= AgentNum);
+
+	const float MaxDistance = 2.0f * Settings.ArenaBounds.Size();
+	const float InvMaxDistance = MaxDistance > UE_SMALL_NUMBER ? 1.0f / MaxDistance : 0.0f;
+
+	for (int32 AgentId = 0; AgentId < AgentNum; AgentId++)
+	{
+		const float DeltaX = TargetX[AgentId] - PositionX[AgentId];
+		const float DeltaY = TargetY[AgentId] - PositionY[AgentId];
+		const float Distance = FMath::Sqrt(DeltaX * DeltaX + DeltaY * DeltaY);
+		const bool bReached = Distance <= Settings.ReachDistance;
+		const bool bBlocked = !bReached && IsAgentBlocked(AgentId);
+
+		float SinYaw, CosYaw;
+		FMath::SinCos(&SinYaw, &CosYaw, FMath::DegreesToRadians(Yaw[AgentId]));
+		const float FacingDot = Distance > UE_SMALL_NUMBER ? (CosYaw * DeltaX + SinYaw * DeltaY) / Distance : 0.0f;
+
+		OutRewards[AgentId] = Settings.Rewards.ComputeStepReward(
+			bReached, bBlocked, Distance, PreviousDistances[AgentId], InvMaxDistance, FacingDot);
+
+		PreviousDistances[AgentId] = Distance;
+		EpisodeSteps[AgentId]++;
+
+		OutCompleted[AgentId] = bReached || EpisodeSteps[AgentId] >= Settings.MaxEpisodeSteps || IsOutOfBounds(AgentId);
+	}
+}
+
+FVector FSCharacterPointMassSim::GetForward(const int32 AgentId) const
+{
+	float SinYaw, CosYaw;
+	FMath::SinCos(&SinYaw, &CosYaw, FMath::DegreesToRadians(Yaw[AgentId]));
+	return FVector(CosYaw, SinYaw, 0.0f);
+}
+
+bool FSCharacterPointMassSim::IsOutOfBounds(const int32 AgentId) const
+{
+	return FMath::Abs(PositionX[AgentId] - Settings.ArenaCenter.X) > Settings.ArenaBounds.X ||
+		FMath::Abs(PositionY[AgentId] - Settings.ArenaCenter.Y) > Settings.ArenaBounds.Y;
+}
+
+void FSCharacterPointMassSim::SetObstacle(const int32 AgentId, const int32 ObstacleIndex, const FBox2f& Box)
+{
+	check(ObstacleIndex >= 0 && ObstacleIndex < Settings.MaxObstacles);
+	Obstacles[AgentId * Settings.MaxObstacles + ObstacleIndex] = Box;
+}
+
+void FSCharacterPointMassSim::SetAgentState(const int32 AgentId, const FVector2f& Position, const float YawDegrees, const FVector2f& Target)
+{
+	PositionX[AgentId] = Position.X;
+	PositionY[AgentId] = Position.Y;
+	VelocityX[AgentId] = 0.0f;
+	VelocityY[AgentId] = 0.0f;
+	Yaw[AgentId] = YawDegrees;
+	TargetX[AgentId] = Target.X;
+	TargetY[AgentId] = Target.Y;
+	PreviousDistances[AgentId] = -1.0f;
+	EpisodeSteps[AgentId] = 0;
+}
+
+bool FSCharacterPointMassSim::IsBlocked(const int32 AgentId, const float X, const float Y, const float Radius) const
+{
+	// Same test as ASObstacleActor::IsLocationBlocked, the boxes span the full height so Z never separates
+	const int32 First = AgentId * Settings.MaxObstacles;
+	for (int32 Index = First; Index < First + Settings.MaxObstacles; Index++)
+	{
+		const FBox2f& Box = Obstacles[Index];
+		if (Box.bIsValid &&
+			X >= Box.Min.X - Radius && X <= Box.Max.X + Radius &&
+			Y >= Box.Min.Y - Radius && Y <= Box.Max.Y + Radius)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void FSCharacterPointMassSim::TraceObstacleRays(const int32 AgentId, TArrayView<const FVector2f> Directions, const float MaxDistance, TArrayView<float> OutDistances) const
+{
+	const FVector2f Origin(PositionX[AgentId], PositionY[AgentId]);
+	const int32 First = AgentId * Settings.MaxObstacles;
+	for (int32 Ray = 0; Ray < Directions.Num(); Ray++)
+	{
+		const FVector2f& Direction = Directions[Ray];
+		const float InvDirectionX = Direction.X != 0.0f ? 1.0f / Direction.X : 1.0e30f;
+		const float InvDirectionY = Direction.Y != 0.0f ? 1.0f / Direction.Y : 1.0e30f;
+
+		float Nearest = MaxDistance;
+		for (int32 Index = First; Index < First + Settings.MaxObstacles; Index++)
+		{
+			const FBox2f& Box = Obstacles[Index];
+			if (!Box.bIsValid)
+			{
+				continue;
+			}
+
+			// Slab test, same as FSObstacleGrid::TraceRays
+			const float EntryX = (Box.Min.X - Origin.X) * InvDirectionX;
+			const float ExitX = (Box.Max.X - Origin.X) * InvDirectionX;
+			const float EntryY = (Box.Min.Y - Origin.Y) * InvDirectionY;
+			const float ExitY = (Box.Max.Y - Origin.Y) * InvDirectionY;
+			const float Near = FMath::Max3(FMath::Min(EntryX, ExitX), FMath::Min(EntryY, ExitY), 0.0f);
+			const float Far = FMath::Min(FMath::Max(EntryX, ExitX), FMath::Max(EntryY, ExitY));
+			if (Near <= Far)
+			{
+				Nearest = FMath::Min(Nearest, Near);
+			}
+		}
+		OutDistances[Ray] = Nearest;
+	}
+}
+
+FVector2f FSCharacterPointMassSim::SamplePoint()
+{
+	return FVector2f(
+		Settings.ArenaCenter.X + Random.FRandRange(-Settings.ArenaBounds.X, Settings.ArenaBounds.X),
+		Settings.ArenaCenter.Y + Random.FRandRange(-Settings.ArenaBounds.Y, Settings.ArenaBounds.Y));
+}
+
+void FSCharacterPointMassSim::GenerateObstacles(const int32 AgentId, const bool bAvoidAgentAndTarget)
+{
+	const int32 First = AgentId * Settings.MaxObstacles;
+	for (int32 Index = First; Index < First + Settings.MaxObstacles; Index++)
+	{
+		Obstacles[Index] = FBox2f(ForceInit);
+	}
+
+	const FVector2f AgentPosition(PositionX[AgentId], PositionY[AgentId]);
+	const FVector2f TargetPosition(TargetX[AgentId], TargetY[AgentId]);
+	const float MaxSizeX = FMath::Min(Settings.MaxObstacleSize, Settings.ArenaBounds.X * 2.0f * 0.8f);
+	const float MaxSizeY = FMath::Min(Settings.MaxObstacleSize, Settings.ArenaBounds.Y * 2.0f * 0.8f);
+
+	// Mirrors USObstacleManager placement: keep clear of the agent and target, spread obstacle centers apart
+	for (int32 Index = First; Index < First + Settings.MaxObstacles; Index++)
+	{
+		for (int32 Attempts = 0; Attempts < 50; Attempts++)
+		{
+			const FVector2f Center = SamplePoint();
+			bool bValid = !bAvoidAgentAndTarget ||
+				(FVector2f::Distance(Center, AgentPosition) >= 150.0f && FVector2f::Distance(Center, TargetPosition) >= 150.0f);
+
+			for (int32 Other = First; bValid && Other < Index; Other++)
+			{
+				bValid = !Obstacles[Other].bIsValid || FVector2f::Distance(Center, Obstacles[Other].GetCenter()) >= Settings.MinObstacleSize;
+			}
+
+			if (bValid)
+			{
+				const FVector2f HalfExtent(
+					Random.FRandRange(Settings.MinObstacleSize, MaxSizeX) * 0.5f,
+					Random.FRandRange(Settings.MinObstacleSize, MaxSizeY) * 0.5f);
+				Obstacles[Index] = FBox2f(Center - HalfExtent, Center + HalfExtent);
+				break;
+			}
+		}
+	}
+}
@@ -5,8 +5,11 @@
 #include "LearningAgentsCompletions.h"
 #include "STargetActor.h"
 #include "Learning/SObstacleManager.h"
+#include "Learning/SObstacleLayoutLibrary.h"
+#include "Learning/SCharacterTrainingStats.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "SCharacter.h"
+#include "SCharacterManagerComponent.h"
 
 USCharacterTrainingEnvironment::USCharacterTrainingEnvironment()
 {
@@ -14,233 +17,768 @@ USCharacterTrainingEnvironment::USCharacterTrainingEnvironment()
 	ObstacleManager = nullptr;
 }
 
-void USCharacterTrainingEnvironment::GatherAgentReward_Implementation(float& OutReward, const int32 AgentId)
+void FSCharacterEnvironmentBatch::SetNum(const int32 Num)
 {
-	OutReward = 0.0f;
+	LocationX.SetNumUninitialized(Num, EAllowShrinking::No);
+	LocationY.SetNumUninitialized(Num, EAllowShrinking::No);
+	LocationZ.SetNumUninitialized(Num, EAllowShrinking::No);
+	ForwardX.SetNumUninitialized(Num, EAllowShrinking::No);
+	ForwardY.SetNumUninitialized(Num, EAllowShrinking::No);
+	ForwardZ.SetNumUninitialized(Num, EAllowShrinking::No);
+	TargetX.SetNumUninitialized(Num, EAllowShrinking::No);
+	TargetY.SetNumUninitialized(Num, EAllowShrinking::No);
+	TargetZ.SetNumUninitialized(Num, EAllowShrinking::No);
+	CenterX.SetNumUninitialized(Num, EAllowShrinking::No);
+	CenterY.SetNumUninitialized(Num, EAllowShrinking::No);
+	ObstacleManagers.SetNumUninitialized(Num, EAllowShrinking::No);
+	ReachDistances.SetNumUninitialized(Num, EAllowShrinking::No);
+	Distances.SetNumUninitialized(Num, EAllowShrinking::No);
+	Flags.SetNumUninitialized(Num, EAllowShrinking::No);
+}
+
+void FSCharacterEnvironmentBatch::Reserve(const int32 Num)
+{
+	LocationX.Reserve(Num);
+	LocationY.Reserve(Num);
+	LocationZ.Reserve(Num);
+	ForwardX.Reserve(Num);
+	ForwardY.Reserve(Num);
+	ForwardZ.Reserve(Num);
+	TargetX.Reserve(Num);
+	TargetY.Reserve(Num);
+	TargetZ.Reserve(Num);
+	CenterX.Reserve(Num);
+	CenterY.Reserve(Num);
+	ObstacleManagers.Reserve(Num);
+	ReachDistances.Reserve(Num);
+	Distances.Reserve(Num);
+	Flags.Reserve(Num);
+}
 
-	// Get the character agent
-	ASCharacter* Character = Cast<ASCharacter>(Manager->GetAgent(AgentId, ASCharacter::StaticClass()));
-	if (!Character || !TargetActor)
+void USCharacterTrainingEnvironment::EnsureAgentState()
+{
+	const int32 MaxAgentNum = Manager ? Manager->GetMaxAgentNum() : 0;
+	if (EpisodeSteps.Num() == MaxAgentNum)
 	{
 		return;
 	}
 
-	FVector CharacterLocation = Character->GetActorLocation();
-	FVector TargetLocation = TargetActor->GetActorLocation();
-	float CurrentDistance = FVector::Dist(CharacterLocation, TargetLocation);
+	// Dense arrays indexed directly by AgentId
+	PreviousDistances.Init(-1.0f, MaxAgentNum);
+	EpisodeSteps.Init(0, MaxAgentNum);
+	HeldRewards.Init(0.0f, MaxAgentNum);
+	HeldEndFlags.Init(0, MaxAgentNum);
+	HeldStepRewards.Reserve(MaxAgentNum);
+	EnvironmentBatch.Reserve(MaxAgentNum);
+	SnapshotAgentIds.Reserve(MaxAgentNum);
+	SnapshotStep = MAX_uint64;
+}
 
-	// Check if agent reached the target
-	if (TargetActor->IsLocationWithinReach(CharacterLocation))
+void USCharacterTrainingEnvironment::GatherEnvironmentSnapshot(const TArray<int32>& AgentIds)
+{
+	typedef FSCharacterEnvironmentBatch FBatch;
+
+	// Rewards and completions of one step read the same world, so whichever runs second reuses the first one's snapshot
+	if (SnapshotStep == StepCounter && SnapshotAgentIds == AgentIds)
 	{
-		OutReward += ReachTargetReward;
-		UE_LOG(LogTemp, Log, TEXT("Agent %d reached target! Reward: %f"), AgentId, ReachTargetReward);
+		return;
+	}
+	SnapshotStep = StepCounter;
+	SnapshotAgentIds = AgentIds;
+
+	const int32 AgentNum = AgentIds.Num();
+	FBatch& Batch = EnvironmentBatch;
+	Batch.SetNum(AgentNum);
+
+	USCharacterManagerComponent* ArenaManager = Cast<USCharacterManagerComponent>(Manager);
+	const FSCharacterPointMassSim* Sim = ArenaManager ? ArenaManager->GetPointMassSim() : nullptr;
+
+	// Single pass over the agents, reading only what the kernels need
+	for (int32 Index = 0; Index < AgentNum && Sim; Index++)
+	{
+		// Point-mass agents are their own arena, read them straight from the simulator
+		const int32 AgentId = AgentIds[Index];
+		const FVector Location = Sim->GetLocation(AgentId);
+		const FVector Forward = Sim->GetForward(AgentId);
+		const FVector TargetLocation = Sim->GetTargetLocation(AgentId);
+
+		Batch.Flags[Index] = FBatch::Valid | (Sim->IsAgentBlocked(AgentId) ? FBatch::Blocked : 0);
+		Batch.ObstacleManagers[Index] = nullptr;
+		Batch.CenterX[Index] = Sim->GetSettings().ArenaCenter.X;
+		Batch.CenterY[Index] = Sim->GetSettings().ArenaCenter.Y;
+		Batch.ReachDistances[Index] = Sim->GetSettings().ReachDistance;
+		Batch.LocationX[Index] = Location.X;
+		Batch.LocationY[Index] = Location.Y;
+		Batch.LocationZ[Index] = Location.Z;
+		Batch.ForwardX[Index] = Forward.X;
+		Batch.ForwardY[Index] = Forward.Y;
+		Batch.ForwardZ[Index] = Forward.Z;
+		Batch.TargetX[Index] = TargetLocation.X;
+		Batch.TargetY[Index] = TargetLocation.Y;
+		Batch.TargetZ[Index] = TargetLocation.Z;
+	}
+
+	for (int32 Index = 0; Index < AgentNum && !Sim; Index++)
+	{
+		const FSCharacterArena& Arena = GetAgentArena(ArenaManager, AgentIds[Index]);
+		const ASTargetActor* ArenaTarget = GetAgentTarget(ArenaManager, AgentIds[Index]);
+		const FVector TargetLocation = ArenaTarget ? ArenaTarget->GetActorLocation() : FVector::ZeroVector;
+		Batch.ObstacleManagers[Index] = Arena.ObstacleManager;
+		Batch.CenterX[Index] = Arena.Center.X;
+		Batch.CenterY[Index] = Arena.Center.Y;
+		Batch.ReachDistances[Index] = ArenaTarget ? ArenaTarget->ReachDistance : 0.0f;
+
+		const ASCharacter* Character = Cast<ASCharacter>(Manager->GetAgent(AgentIds[Index], ASCharacter::StaticClass()));
+		if (!Character || !ArenaTarget)
+		{
+			Batch.Flags[Index] = 0;
+			Batch.LocationX[Index] = Batch.LocationY[Index] = Batch.LocationZ[Index] = 0.0f;
+			Batch.ForwardX[Index] = Batch.ForwardY[Index] = Batch.ForwardZ[Index] = 0.0f;
+		}
+		else
+		{
+			const FTransform& Transform = Character->GetActorTransform();
+			const FVector Location = Transform.GetLocation();
+			const FVector Forward = Transform.GetUnitAxis(EAxis::X);
+
+			Batch.Flags[Index] = FBatch::Valid | (Character->IsDead() ? FBatch::Dead : 0);
+			Batch.LocationX[Index] = Location.X;
+			Batch.LocationY[Index] = Location.Y;
+			Batch.LocationZ[Index] = Location.Z;
+			Batch.ForwardX[Index] = Forward.X;
+			Batch.ForwardY[Index] = Forward.Y;
+			Batch.ForwardZ[Index] = Forward.Z;
+		}
+
+		Batch.TargetX[Index] = TargetLocation.X;
+		Batch.TargetY[Index] = TargetLocation.Y;
+		Batch.TargetZ[Index] = TargetLocation.Z;
 	}
-	// Check for obstacle collision penalty
-	else if (bUseObstacles && ObstacleManager && ObstacleManager->IsLocationBlocked(CharacterLocation, 50.0f))
+
+	// Distance, reach and bounds tests for all agents in one branch-free pass
+	const float BoundsX = ResetBounds.X;
+	const float BoundsY = ResetBounds.Y;
+
+	for (int32 Index = 0; Index < AgentNum; Index++)
 	{
-		OutReward += -10.0f; // Penalty for hitting obstacles
-		// UE_LOG(LogTemp, VeryVerbose, TEXT("Agent %d hit obstacle, penalty: -10.0f"), AgentId);
+		const float DeltaX = Batch.TargetX[Index] - Batch.LocationX[Index];
+		const float DeltaY = Batch.TargetY[Index] - Batch.LocationY[Index];
+		const float DeltaZ = Batch.TargetZ[Index] - Batch.LocationZ[Index];
+		const float Distance = FMath::Sqrt(DeltaX * DeltaX + DeltaY * DeltaY + DeltaZ * DeltaZ);
+		Batch.Distances[Index] = Distance;
+
+		const bool bReached = Distance <= Batch.ReachDistances[Index];
+		const bool bOutOfBounds =
+			FMath::Abs(Batch.LocationX[Index] - Batch.CenterX[Index]) > BoundsX ||
+			FMath::Abs(Batch.LocationY[Index] - Batch.CenterY[Index]) > BoundsY;
+
+		// Episode ends latched during held steps still count for valid agents
+		const uint8 HeldFlags = (Batch.Flags[Index] & FBatch::Valid) ? HeldEndFlags[AgentIds[Index]] : 0;
+		Batch.Flags[Index] |= (bReached ? FBatch::Reached : 0) | (bOutOfBounds ? FBatch::OutOfBounds : 0) | HeldFlags;
 	}
-	else
+
+	// Obstacle penalty check only matters for agents that have not reached the target
+	// Arenas take agents round-robin, so the agents are sorted by obstacle manager and each manager gets one batched query
+	if (bUseObstacles)
 	{
-		// Distance-based reward (closer = better)
-		float MaxDistance = FVector::Dist(ResetCenter - ResetBounds, ResetCenter + ResetBounds);
-		float NormalizedDistance = FMath::Clamp(CurrentDistance / MaxDistance, 0.0f, 1.0f);
-		OutReward += (1.0f - NormalizedDistance) * DistanceRewardScale;
+		BlockedQueryIndices.Reset();
+		for (int32 Index = 0; Index < AgentIds.Num(); Index++)
+		{
+			if (Batch.ObstacleManagers[Index] && (Batch.Flags[Index] & (FBatch::Valid | FBatch::Reached)) == FBatch::Valid)
+			{
+				BlockedQueryIndices.Add(Index);
+			}
+		}
+
+		BlockedQueryIndices.Sort([&Batch](const int32 Lhs, const int32 Rhs)
+		{
+			const UPTRINT LhsManager = (UPTRINT)Batch.ObstacleManagers[Lhs];
+			const UPTRINT RhsManager = (UPTRINT)Batch.ObstacleManagers[Rhs];
+			return LhsManager != RhsManager ? LhsManager < RhsManager : Lhs < Rhs;
+		});
 
-		// Movement towards target reward
-		if (PreviousDistances.Contains(AgentId))
+		BlockedQueryLocations.Reset();
+		for (const int32 Index : BlockedQueryIndices)
 		{
-			float PreviousDistance = PreviousDistances[AgentId];
-			if (CurrentDistance < PreviousDistance)
+			BlockedQueryLocations.Add(FVector(Batch.LocationX[Index], Batch.LocationY[Index], Batch.LocationZ[Index]));
+		}
+		BlockedQueryResults.SetNumUninitialized(BlockedQueryIndices.Num(), EAllowShrinking::No);
+
+		for (int32 RunStart = 0; RunStart < BlockedQueryIndices.Num();)
+		{
+			const USObstacleManager* ArenaObstacles = Batch.ObstacleManagers[BlockedQueryIndices[RunStart]];
+			int32 RunEnd = RunStart + 1;
+			while (RunEnd < BlockedQueryIndices.Num() && Batch.ObstacleManagers[BlockedQueryIndices[RunEnd]] == ArenaObstacles)
 			{
-				OutReward += MovementTowardsTargetReward;
+				RunEnd++;
 			}
+
+			ArenaObstacles->AreLocationsBlocked(
+				TArrayView<const FVector>(BlockedQueryLocations).Slice(RunStart, RunEnd - RunStart), 50.0f,
+				TArrayView<bool>(BlockedQueryResults).Slice(RunStart, RunEnd - RunStart));
+			RunStart = RunEnd;
 		}
-		
+
+		for (int32 Query = 0; Query < BlockedQueryIndices.Num(); Query++)
+		{
+			Batch.Flags[BlockedQueryIndices[Query]] |= BlockedQueryResults[Query] ? FBatch::Blocked : 0;
+		}
+	}
+}
+
+void USCharacterTrainingEnvironment::EvaluateStepRewards(const TArray<int32>& AgentIds, TArrayView<float> OutRewards)
+{
+	typedef FSCharacterEnvironmentBatch FBatch;
+
+	EnsureAgentState();
+	GatherEnvironmentSnapshot(AgentIds);
+	const FBatch& Batch = EnvironmentBatch;
+
+	const float MaxDistance = FVector::Dist(ResetCenter - ResetBounds, ResetCenter + ResetBounds);
+	const float InvMaxDistance = MaxDistance > UE_SMALL_NUMBER ? 1.0f / MaxDistance : 0.0f;
+	const FSCharacterTaskRewards TaskRewards = GetTaskRewards();
+
+	for (int32 Index = 0; Index < AgentIds.Num(); Index++)
+	{
+		const uint8 Flags = Batch.Flags[Index];
+		if (!(Flags & FBatch::Valid))
+		{
+			OutRewards[Index] = 0.0f;
+			continue;
+		}
+
+		const int32 AgentId = AgentIds[Index];
+		const float CurrentDistance = Batch.Distances[Index];
+
 		// Facing target reward - encourage agent to look at the target
-		FVector DirectionToTarget = (TargetLocation - CharacterLocation).GetSafeNormal();
-		FVector CharacterForward = Character->GetActorForwardVector();
-		float DotProduct = FVector::DotProduct(CharacterForward, DirectionToTarget);
-		
-		// DotProduct ranges from -1 (opposite direction) to 1 (same direction)
-		// Convert to 0-1 range and apply reward
-		float FacingAlignment = (DotProduct + 1.0f) * 0.5f;
-		OutReward += FacingAlignment * FacingTargetReward;
+		const float InvDistance = CurrentDistance > UE_SMALL_NUMBER ? 1.0f / CurrentDistance : 0.0f;
+		const float DotProduct = InvDistance * (
+			Batch.ForwardX[Index] * (Batch.TargetX[Index] - Batch.LocationX[Index]) +
+			Batch.ForwardY[Index] * (Batch.TargetY[Index] - Batch.LocationY[Index]) +
+			Batch.ForwardZ[Index] * (Batch.TargetZ[Index] - Batch.LocationZ[Index]));
+
+		OutRewards[Index] = TaskRewards.ComputeStepReward((Flags & FBatch::Reached) != 0, (Flags & FBatch::Blocked) != 0,
+			CurrentDistance, PreviousDistances[AgentId], InvMaxDistance, DotProduct);
+
+		// Update previous distance for next step
+		PreviousDistances[AgentId] = CurrentDistance;
 	}
+}
 
-	// Time step penalty to encourage efficiency
-	OutReward += TimeStepPenalty;
+void USCharacterTrainingEnvironment::GatherAgentRewards_Implementation(TArray<float>& OutRewards, const TArray<int32>& AgentIds)
+{
+	SCOPE_COOP_TRAINING_STAGE(GatherRewards);
+	typedef FSCharacterEnvironmentBatch FBatch;
+
+	OutRewards.Reset();
+	OutRewards.SetNumZeroed(AgentIds.Num());
+	EvaluateStepRewards(AgentIds, OutRewards);
 
-	// Update previous distance for next step
-	PreviousDistances.Add(AgentId, CurrentDistance);
+	const FBatch& Batch = EnvironmentBatch;
+	FSCharacterTrainingStats& Stats = FSCharacterTrainingStats::Get();
+	const bool bVerbose = FSCharacterTrainingStats::IsVerbose();
 
-	// Increment episode step counter
-	if (EpisodeSteps.Contains(AgentId))
+	for (int32 Index = 0; Index < AgentIds.Num(); Index++)
 	{
+		const uint8 Flags = Batch.Flags[Index];
+		if (!(Flags & FBatch::Valid))
+		{
+			continue;
+		}
+
+		// Rewards earned while the previous action was held belong to this decision's sample
+		const int32 AgentId = AgentIds[Index];
+		OutRewards[Index] += HeldRewards[AgentId];
+		HeldRewards[AgentId] = 0.0f;
+		Stats.RecordStep(OutRewards[Index]);
+
+		// Check if agent reached the target
+		UE_CLOG(bVerbose && (Flags & FBatch::Reached), LogTemp, Log, TEXT("Agent %d reached target! Reward: %f"), AgentId, ReachTargetReward);
+
+		// Episodes are measured in decisions, held steps don't count
 		EpisodeSteps[AgentId]++;
 	}
-	else
+}
+
+void USCharacterTrainingEnvironment::AccumulateHeldRewards(const TArray<int32>& AgentIds)
+{
+	SCOPE_COOP_TRAINING_STAGE(GatherRewards);
+	typedef FSCharacterEnvironmentBatch FBatch;
+
+	HeldStepRewards.SetNumUninitialized(AgentIds.Num(), EAllowShrinking::No);
+	EvaluateStepRewards(AgentIds, HeldStepRewards);
+
+	const FBatch& Batch = EnvironmentBatch;
+	for (int32 Index = 0; Index < AgentIds.Num(); Index++)
 	{
-		EpisodeSteps.Add(AgentId, 1);
+		const int32 AgentId = AgentIds[Index];
+		if (!(Batch.Flags[Index] & FBatch::Valid) || HeldEndFlags[AgentId])
+		{
+			continue;
+		}
+
+		// Reaching the target, leaving the bounds or dying mid-hold ends the episode at the next decision, which pays
+		// the reach reward once, and nothing after the end is banked
+		const uint8 EndFlags = Batch.Flags[Index] & (FBatch::Reached | FBatch::OutOfBounds | FBatch::Dead);
+		if (EndFlags)
+		{
+			HeldEndFlags[AgentId] = EndFlags;
+			continue;
+		}
+
+		HeldRewards[AgentId] += HeldStepRewards[Index];
 	}
 }
 
-void USCharacterTrainingEnvironment::GatherAgentCompletion_Implementation(ELearningAgentsCompletion& OutCompletion, const int32 AgentId)
+void USCharacterTrainingEnvironment::GatherAgentCompletions_Implementation(TArray<ELearningAgentsCompletion>& OutCompletions, const TArray<int32>& AgentIds)
 {
-	OutCompletion = ELearningAgentsCompletion::Running;
+	SCOPE_COOP_TRAINING_STAGE(GatherCompletions);
+	typedef FSCharacterEnvironmentBatch FBatch;
+
+	OutCompletions.Reset();
+	OutCompletions.Init(ELearningAgentsCompletion::Running, AgentIds.Num());
 
-	// Get the character agent
-	ASCharacter* Character = Cast<ASCharacter>(Manager->GetAgent(AgentId, ASCharacter::StaticClass()));
-	if (!Character || !TargetActor)
+	EnsureAgentState();
+	GatherEnvironmentSnapshot(AgentIds);
+	const FBatch& Batch = EnvironmentBatch;
+	const int32 MaxSteps = GetMaxEpisodeDecisions();
+	FSCharacterTrainingStats& Stats = FSCharacterTrainingStats::Get();
+	const bool bVerbose = FSCharacterTrainingStats::IsVerbose();
+
+	for (int32 Index = 0; Index < AgentIds.Num(); Index++)
 	{
-		UE_LOG(LogTemp, Error, TEXT("Agent %d: Completion check failed - Character: %s, Target: %s"), 
-			AgentId, Character ? TEXT("Valid") : TEXT("NULL"), TargetActor ? TEXT("Valid") : TEXT("NULL"));
-		OutCompletion = ELearningAgentsCompletion::Termination;
-		return;
+		const int32 AgentId = AgentIds[Index];
+		const uint8 Flags = Batch.Flags[Index];
+		ESCharacterEpisodeEnd EpisodeEnd = ESCharacterEpisodeEnd::Num;
+
+		if (!(Flags & FBatch::Valid))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Agent %d: Completion check failed - Character or Target is NULL"), AgentId);
+			EpisodeEnd = ESCharacterEpisodeEnd::Invalid;
+		}
+		// Check if agent reached the target
+		else if (Flags & FBatch::Reached)
+		{
+			UE_CLOG(bVerbose, LogTemp, Log, TEXT("Agent %d: Episode complete - reached target"), AgentId);
+			EpisodeEnd = ESCharacterEpisodeEnd::ReachedTarget;
+		}
+		// Check if episode has exceeded maximum length
+		else if (EpisodeSteps[AgentId] >= MaxSteps)
+		{
+			UE_CLOG(bVerbose, LogTemp, Log, TEXT("Agent %d: Episode complete - max steps reached (%d)"), AgentId, EpisodeSteps[AgentId]);
+			EpisodeEnd = ESCharacterEpisodeEnd::MaxSteps;
+		}
+		// Check if character is outside bounds
+		else if (Flags & FBatch::OutOfBounds)
+		{
+			UE_CLOG(bVerbose, LogTemp, Log, TEXT("Agent %d: Episode complete - out of bounds"), AgentId);
+			EpisodeEnd = ESCharacterEpisodeEnd::OutOfBounds;
+		}
+		// Check if character died
+		else if (Flags & FBatch::Dead)
+		{
+			UE_CLOG(bVerbose, LogTemp, Log, TEXT("Agent %d: Episode complete - character died"), AgentId);
+			EpisodeEnd = ESCharacterEpisodeEnd::Died;
+		}
+
+		if (EpisodeEnd != ESCharacterEpisodeEnd::Num)
+		{
+			OutCompletions[Index] = ELearningAgentsCompletion::Termination;
+			Stats.RecordEpisodeEnd(EpisodeEnd, EpisodeSteps[AgentId], MaxSteps);
+		}
 	}
+}
+
+void USCharacterTrainingEnvironment::ResetAgentEpisode_Implementation(const int32 AgentId)
+{
+	ResetAgentEpisodes_Implementation({ AgentId });
+}
 
-	// Check if agent reached the target
-	if (TargetActor->IsLocationWithinReach(Character->GetActorLocation()))
+void USCharacterTrainingEnvironment::ResetAgentEpisodes_Implementation(const TArray<int32>& AgentIds)
+{
+	SCOPE_COOP_TRAINING_STAGE(ResetEpisodes);
+	USCharacterManagerComponent* ArenaManager = Cast<USCharacterManagerComponent>(Manager);
+
+	// Reset episode step counters
+	EnsureAgentState();
+	for (const int32 AgentId : AgentIds)
 	{
-		UE_LOG(LogTemp, Log, TEXT("Agent %d (%s): Episode complete - reached target"), AgentId, *Character->GetName());
-		OutCompletion = ELearningAgentsCompletion::Termination;
-		return;
+		EpisodeSteps[AgentId] = 0;
+		PreviousDistances[AgentId] = -1.0f;
+		HeldRewards[AgentId] = 0.0f;
+		HeldEndFlags[AgentId] = 0;
 	}
 
-	// Check if episode has exceeded maximum length
-	int32 CurrentSteps = EpisodeSteps.FindRef(AgentId);
-	if (CurrentSteps >= (int32)MaxEpisodeLength)
+	// The simulator owns agent, target and obstacle placement for point-mass agents
+	if (FSCharacterPointMassSim* Sim = ArenaManager ? ArenaManager->GetPointMassSim() : nullptr)
 	{
-		UE_LOG(LogTemp, Log, TEXT("Agent %d (%s): Episode complete - max steps reached (%d)"), 
-			AgentId, *Character->GetName(), CurrentSteps);
-		OutCompletion = ELearningAgentsCompletion::Termination;
+		for (const int32 AgentId : AgentIds)
+		{
+			Sim->ResetAgent(AgentId);
+			FSCharacterTrainingStats::Get().RecordAgentReset();
+		}
 		return;
 	}
 
-	// Check if character is outside bounds
-	FVector CharacterLocation = Character->GetActorLocation();
-	FVector BoundsMin = ResetCenter - ResetBounds;
-	FVector BoundsMax = ResetCenter + ResetBounds;
-	
-	if (CharacterLocation.X < BoundsMin.X || CharacterLocation.X > BoundsMax.X ||
-		CharacterLocation.Y < BoundsMin.Y || CharacterLocation.Y > BoundsMax.Y)
+	// Group the batch by arena so each arena's layout and target are handled once however many of its agents reset
+	TMap<FSCharacterArena*, TArray<int32>> ArenaResets;
+	for (const int32 AgentId : AgentIds)
 	{
-		UE_LOG(LogTemp, Log, TEXT("Agent %d (%s): Episode complete - out of bounds"), AgentId, *Character->GetName());
-		OutCompletion = ELearningAgentsCompletion::Termination;
-		return;
+		ArenaResets.FindOrAdd(&GetAgentArena(ArenaManager, AgentId)).Add(AgentId);
 	}
 
-	// Check if character died
-	if (Character->IsDead())
+	for (TPair<FSCharacterArena*, TArray<int32>>& ArenaReset : ArenaResets)
 	{
-		UE_LOG(LogTemp, Log, TEXT("Agent %d (%s): Episode complete - character died"), AgentId, *Character->GetName());
-		OutCompletion = ELearningAgentsCompletion::Termination;
-		return;
+		ResetArenaAgents(*ArenaReset.Key, ArenaReset.Value);
 	}
 }
 
-void USCharacterTrainingEnvironment::ResetAgentEpisode_Implementation(const int32 AgentId)
+void USCharacterTrainingEnvironment::ResetArenaAgents(FSCharacterArena& Arena, const TArray<int32>& AgentIds)
 {
-	// Get the character agent
-	ASCharacter* Character = Cast<ASCharacter>(Manager->GetAgent(AgentId, ASCharacter::StaticClass()));
-	if (!Character || !TargetActor)
+	ASTargetActor* ArenaTarget = Arena.TargetActor;
+	if (!ArenaTarget)
 	{
-		UE_LOG(LogTemp, Error, TEXT("SCharacterTrainingEnvironment: Reset failed for Agent %d - Character: %s, Target: %s"), 
-			AgentId, 
-			Character ? TEXT("Valid") : TEXT("NULL"), 
-			TargetActor ? TEXT("Valid") : TEXT("NULL"));
+		UE_LOG(LogTemp, Error, TEXT("SCharacterTrainingEnvironment: Reset failed for %d agent(s) - Target: NULL"), AgentIds.Num());
 		return;
 	}
 
-	// Initialize obstacle manager if needed
-	if (bUseObstacles && !ObstacleManager)
+	USCharacterManagerComponent* ArenaManager = Cast<USCharacterManagerComponent>(Manager);
+
+	// Initialize the arena's obstacle manager if needed
+	USObstacleManager* ArenaObstacles = bUseObstacles ? GetOrCreateObstacleManager(Arena) : nullptr;
+
+	const FVector ArenaCenter = Arena.Center;
+	const FBox2D ResetArea(FVector2D(ArenaCenter - ResetBounds), FVector2D(ArenaCenter + ResetBounds));
+
+	// A Dynamic layout is rebuilt whole when every agent of the arena resets in this batch (or it has no layout yet),
+	// otherwise only the obstacles around the reset agents' new starts are, once for the whole batch. Library layouts
+	// are never resampled in part, a partial reset keeps the current one and starts on its spawn points
+	const bool bDynamicObstacles = ArenaObstacles && ArenaObstacles->ObstacleMode == EObstacleMode::Dynamic;
+	const bool bUseLayoutLibrary = bDynamicObstacles && ArenaObstacles->HasLayoutLibrary();
+	const int32 ArenaAgentNum = Arena.AgentIds.Num() > 0 ? Arena.AgentIds.Num() : Manager->GetAgentNum();
+	const bool bRegenerateLayout = bDynamicObstacles && (AgentIds.Num() >= ArenaAgentNum || ArenaObstacles->GetObstacleNum() == 0 ||
+		(bUseLayoutLibrary && ArenaObstacles->GetCurrentLayoutIndex() == INDEX_NONE));
+	const bool bRegenerateRegion = bDynamicObstacles && !bRegenerateLayout && !bUseLayoutLibrary;
+
+	// Library layouts are picked first, the characters then start on the layout's precomputed free points
+	if (bRegenerateLayout && bUseLayoutLibrary)
 	{
-		ObstacleManager = NewObject<USObstacleManager>(this);
-		ObstacleManager->EnvironmentCenter = ResetCenter;
-		ObstacleManager->EnvironmentBounds = ResetBounds;
-		ObstacleManager->MaxObstacles = MaxObstacles;
-		ObstacleManager->MinObstacleSize = MinObstacleSize;
-		ObstacleManager->MaxObstacleSize = MaxObstacleSize;
-		ObstacleManager->SetObstacleMode(ObstacleMode); // Set the stored mode
-		ObstacleManager->FindAndSetLocationVolume(); // Try to find LocationVolume
-		// Don't initialize obstacles here - let the mode-specific logic handle it
+		SCOPE_COOP_TRAINING_STAGE(ObstacleRegeneration);
+		ArenaObstacles->ApplyLibraryLayout();
 	}
 
-	// Reset episode step counter
-	EpisodeSteps.Add(AgentId, 0);
-	PreviousDistances.Remove(AgentId);
+	// Reset characters to random positions with proper Z offset to avoid floor clipping
+	TArray<ASCharacter*, TInlineAllocator<32>> Characters;
+	TArray<FVector, TInlineAllocator<32>> CharacterResetLocations;
+	TArray<FVector2D, TInlineAllocator<32>> TakenSpawnPoints;
+	for (const int32 AgentId : AgentIds)
+	{
+		// Get the character agent
+		ASCharacter* Character = Cast<ASCharacter>(Manager->GetAgent(AgentId, ASCharacter::StaticClass()));
+		if (!Character)
+		{
+			UE_LOG(LogTemp, Error, TEXT("SCharacterTrainingEnvironment: Reset failed for Agent %d - Character: NULL"), AgentId);
+		}
+
+		FVector CharacterResetLocation;
+		FVector2D SpawnPoint;
+		if (bUseLayoutLibrary && ArenaObstacles->FindLibrarySpawnPoint(ResetArea, TakenSpawnPoints, SpawnPoint))
+		{
+			// Each agent of the batch gets a spawn point of its own
+			TakenSpawnPoints.Add(SpawnPoint);
+			CharacterResetLocation = FVector(SpawnPoint, ArenaCenter.Z + FMath::Max(ResetBounds.Z, 100.0f));
+		}
+		else
+		{
+			int32 CharacterAttempts = 0;
+			do {
+				CharacterResetLocation.X = ArenaCenter.X + FMath::RandRange(-ResetBounds.X, ResetBounds.X);
+				CharacterResetLocation.Y = ArenaCenter.Y + FMath::RandRange(-ResetBounds.Y, ResetBounds.Y);
+				CharacterResetLocation.Z = ArenaCenter.Z + FMath::Max(ResetBounds.Z, 100.0f); // Ensure minimum 100 units above ground
+				CharacterAttempts++;
+			} while (ArenaObstacles && ArenaObstacles->IsLocationBlocked(CharacterResetLocation, 50.0f) && CharacterAttempts < 50);
+		}
 
-	// Reset character to random position with proper Z offset to avoid floor clipping
-	FVector CharacterResetLocation;
-	int32 CharacterAttempts = 0;
-	do {
-		CharacterResetLocation.X = ResetCenter.X + FMath::RandRange(-ResetBounds.X, ResetBounds.X);
-		CharacterResetLocation.Y = ResetCenter.Y + FMath::RandRange(-ResetBounds.Y, ResetBounds.Y);
-		CharacterResetLocation.Z = ResetCenter.Z + FMath::Max(ResetBounds.Z, 100.0f); // Ensure minimum 100 units above ground
-		CharacterAttempts++;
-	} while (bUseObstacles && ObstacleManager && ObstacleManager->IsLocationBlocked(CharacterResetLocation, 50.0f) && CharacterAttempts < 50);
+		Characters.Add(Character);
+		CharacterResetLocations.Add(CharacterResetLocation);
+	}
 
 	// Initialize or regenerate obstacles based on mode
-	if (bUseObstacles && ObstacleManager)
+	if (ArenaObstacles)
 	{
-		if (ObstacleManager->ObstacleMode == EObstacleMode::Dynamic)
+		SCOPE_COOP_TRAINING_STAGE(ObstacleRegeneration);
+		if (bRegenerateLayout && !bUseLayoutLibrary)
 		{
-			// Use smart placement for dynamic obstacles
-			ObstacleManager->InitializeObstaclesWithSmartPlacement(CharacterResetLocation, TargetActor->GetActorLocation());
+			// One layout for the whole batch, clear of every new start and the current target
+			TArray<FVector, TInlineAllocator<33>> AvoidLocations(CharacterResetLocations);
+			AvoidLocations.Add(ArenaTarget->GetActorLocation());
+			ArenaObstacles->InitializeObstaclesAroundLocations(AvoidLocations);
+		}
+		else if (bRegenerateRegion && CharacterResetLocations.Num() > 0)
+		{
+			// Resample the walls around the new starts, the arena's agents still mid-episode keep theirs and their targets' surroundings
+			FBox2D ResetRegion(ForceInit);
+			for (const FVector& CharacterResetLocation : CharacterResetLocations)
+			{
+				ResetRegion += FVector2D(CharacterResetLocation);
+			}
+			ResetRegion = ResetRegion.ExpandBy(DynamicResetRegionRadius);
+
+			TArray<FVector, TInlineAllocator<64>> ProtectedLocations;
+			auto ProtectAgent = [&](const int32 OtherAgentId)
+			{
+				if (AgentIds.Contains(OtherAgentId) || !Manager->HasAgent(OtherAgentId))
+				{
+					return;
+				}
+				if (const AActor* OtherAgent = Cast<AActor>(Manager->GetAgent(OtherAgentId, ASCharacter::StaticClass())))
+				{
+					ProtectedLocations.Add(OtherAgent->GetActorLocation());
+				}
+				if (const ASTargetActor* OtherTarget = GetAgentTarget(ArenaManager, OtherAgentId))
+				{
+					ProtectedLocations.Add(OtherTarget->GetActorLocation());
+				}
+			};
+
+			if (Arena.AgentIds.Num() > 0)
+			{
+				for (const int32 OtherAgentId : Arena.AgentIds)
+				{
+					ProtectAgent(OtherAgentId);
+				}
+			}
+			else
+			{
+				for (int32 OtherAgentId = 0; OtherAgentId < Manager->GetMaxAgentNum(); OtherAgentId++)
+				{
+					ProtectAgent(OtherAgentId);
+				}
+			}
+
+			ArenaObstacles->RegenerateObstaclesInRegion(ResetRegion, CharacterResetLocations, ProtectedLocations);
 		}
-		else if (ObstacleManager->ObstacleMode == EObstacleMode::Static && ObstacleManager->CurrentObstacles.Num() == 0)
+		else if (ArenaObstacles->ObstacleMode == EObstacleMode::Static && ArenaObstacles->GetObstacleNum() == 0)
 		{
 			// Initialize static obstacles only if they haven't been created yet
-			ObstacleManager->InitializeObstacles();
+			ArenaObstacles->InitializeObstacles();
 		}
 	}
 
 	// Use the character's learning reset method
-	Character->ResetForLearning(CharacterResetLocation, FRotator::ZeroRotator);
+	for (int32 Index = 0; Index < Characters.Num(); Index++)
+	{
+		if (Characters[Index])
+		{
+			Characters[Index]->ResetForLearning(CharacterResetLocations[Index], FRotator::ZeroRotator);
+		}
+	}
 
 	// Reset target to random position (ensuring minimum distance from character)
-	// For multi-agent, we only move the target when the first agent resets to avoid conflicts
-	if (AgentId == 0 || !TargetActor)
+	// An agent's own target moves with it, the arena's shared target only moves when the arena's first agent resets
+	const int32 ArenaOwnerId = Arena.AgentIds.Num() > 0 ? Arena.AgentIds[0] : 0;
+	for (int32 Index = 0; Index < AgentIds.Num(); Index++)
 	{
+		const int32 AgentId = AgentIds[Index];
+		ASTargetActor* AgentTarget = GetAgentTarget(ArenaManager, AgentId);
+		if (!AgentTarget || !Characters[Index] || (AgentTarget == ArenaTarget && AgentId != ArenaOwnerId))
+		{
+			continue;
+		}
+
+		const FVector& CharacterResetLocation = CharacterResetLocations[Index];
 		FVector TargetResetLocation;
 		int32 Attempts = 0;
 		do {
-			TargetResetLocation.X = ResetCenter.X + FMath::RandRange(-ResetBounds.X, ResetBounds.X);
-			TargetResetLocation.Y = ResetCenter.Y + FMath::RandRange(-ResetBounds.Y, ResetBounds.Y);
-			TargetResetLocation.Z = ResetCenter.Z + FMath::Max(ResetBounds.Z, 100.0f); // Keep above ground
+			TargetResetLocation.X = ArenaCenter.X + FMath::RandRange(-ResetBounds.X, ResetBounds.X);
+			TargetResetLocation.Y = ArenaCenter.Y + FMath::RandRange(-ResetBounds.Y, ResetBounds.Y);
+			TargetResetLocation.Z = ArenaCenter.Z + FMath::Max(ResetBounds.Z, 100.0f); // Keep above ground
 			Attempts++;
 		} while ((FVector::Dist(CharacterResetLocation, TargetResetLocation) < MinDistanceBetweenCharacterAndTarget || 
-				 (bUseObstacles && ObstacleManager && ObstacleManager->IsLocationBlocked(TargetResetLocation, 50.0f))) && 
+				 (ArenaObstacles && ArenaObstacles->IsLocationBlocked(TargetResetLocation, 50.0f))) && 
 				 Attempts < 100);
 
-		TargetActor->SetActorLocation(TargetResetLocation);
+		AgentTarget->SetActorLocation(TargetResetLocation);
 		
-		UE_LOG(LogTemp, Log, TEXT("Reset Target for Agent %d - Target: %s"), AgentId, *TargetResetLocation.ToString());
+		FSCharacterTrainingStats::Get().RecordTargetReset();
+		UE_CLOG(FSCharacterTrainingStats::IsVerbose(), LogTemp, Log, TEXT("Reset Target for Agent %d - Target: %s"), AgentId, *TargetResetLocation.ToString());
+	}
+
+	for (int32 Index = 0; Index < AgentIds.Num(); Index++)
+	{
+		if (!Characters[Index])
+		{
+			continue;
+		}
+
+		FSCharacterTrainingStats::Get().RecordAgentReset();
+		UE_CLOG(FSCharacterTrainingStats::IsVerbose(), LogTemp, Log, TEXT("Reset Agent %d (%s) - Character: %s, Distance to Target: %f"), 
+			AgentIds[Index], 
+			*Characters[Index]->GetName(),
+			*CharacterResetLocations[Index].ToString(),
+			FVector::Dist(CharacterResetLocations[Index], GetAgentTarget(ArenaManager, AgentIds[Index])->GetActorLocation()));
 	}
+}
 
-	UE_LOG(LogTemp, Log, TEXT("Reset Agent %d (%s) - Character: %s, Distance to Target: %f"), 
-		AgentId, 
-		*Character->GetName(),
-		*CharacterResetLocation.ToString(),
-		FVector::Dist(CharacterResetLocation, TargetActor->GetActorLocation()));
+int32 USCharacterTrainingEnvironment::GetMaxEpisodeDecisions() const
+{
+	// Rounded up so a held episode never runs shorter than MaxEpisodeLength simulation steps
+	return FMath::Max(FMath::CeilToInt(MaxEpisodeLength / FMath::Max(DecisionInterval, 1)), 1);
 }
 
-void USCharacterTrainingEnvironment::ConfigureObstacles(bool bUse, int32 MaxObs, float MinSize, float MaxSize, EObstacleMode Mode)
+FSCharacterTaskRewards USCharacterTrainingEnvironment::GetTaskRewards() const
+{
+	FSCharacterTaskRewards TaskRewards;
+	TaskRewards.ReachTargetReward = ReachTargetReward;
+	TaskRewards.DistanceRewardScale = DistanceRewardScale;
+	TaskRewards.MovementTowardsTargetReward = MovementTowardsTargetReward;
+	TaskRewards.FacingTargetReward = FacingTargetReward;
+	TaskRewards.TimeStepPenalty = TimeStepPenalty;
+	return TaskRewards;
+}
+
+FSCharacterPointMassSimSettings USCharacterTrainingEnvironment::MakePointMassSimSettings() const
+{
+	FSCharacterPointMassSimSettings SimSettings;
+	SimSettings.ArenaCenter = ResetCenter;
+	SimSettings.ArenaBounds = ResetBounds;
+	SimSettings.ReachDistance = TargetActor ? TargetActor->ReachDistance : SimSettings.ReachDistance;
+	SimSettings.MinDistanceBetweenCharacterAndTarget = MinDistanceBetweenCharacterAndTarget;
+	SimSettings.MaxEpisodeSteps = (int32)MaxEpisodeLength;
+	SimSettings.Rewards = GetTaskRewards();
+	SimSettings.MaxObstacles = bUseObstacles ? MaxObstacles : 0;
+	SimSettings.MinObstacleSize = MinObstacleSize;
+	SimSettings.MaxObstacleSize = MaxObstacleSize;
+	SimSettings.bRegenerateObstaclesOnReset = ObstacleMode == EObstacleMode::Dynamic;
+	return SimSettings;
+}
+
+FSCharacterArena& USCharacterTrainingEnvironment::GetAgentArena(USCharacterManagerComponent* ArenaManager, const int32 AgentId)
+{
+	if (FSCharacterArena* Arena = ArenaManager ? ArenaManager->GetAgentArena(AgentId) : nullptr)
+	{
+		return *Arena;
+	}
+
+	// Without tiling every agent shares the reset region and the configured target
+	DefaultArena.Center = ResetCenter;
+	DefaultArena.TargetActor = TargetActor;
+	DefaultArena.bIsPrimary = true;
+	return DefaultArena;
+}
+
+ASTargetActor* USCharacterTrainingEnvironment::GetAgentTarget(const USCharacterManagerComponent* ArenaManager, const int32 AgentId) const
+{
+	ASTargetActor* AgentTarget = ArenaManager ? ArenaManager->GetAgentTarget(AgentId) : nullptr;
+	return AgentTarget ? AgentTarget : TargetActor;
+}
+
+USObstacleManager* USCharacterTrainingEnvironment::GetOrCreateObstacleManager(FSCharacterArena& Arena)
+{
+	if (Arena.ObstacleManager)
+	{
+		return Arena.ObstacleManager;
+	}
+
+	// The first arena sits on the level's reset region and may use its LocationVolume
+	const bool bIsPrimaryArena = Arena.bIsPrimary;
+	if (bIsPrimaryArena && ObstacleManager)
+	{
+		Arena.ObstacleManager = ObstacleManager;
+		RegisterDefaultObstacleManager(Arena);
+		return ObstacleManager;
+	}
+
+	// Tiled arenas copy the primary arena's obstacle height, so create that one first
+	USCharacterManagerComponent* ArenaManager = Cast<USCharacterManagerComponent>(Manager);
+	if (!bIsPrimaryArena && !ObstacleManager && ArenaManager && ArenaManager->GetArenaNum() > 0 && ArenaManager->GetArena(0).bIsPrimary)
+	{
+		GetOrCreateObstacleManager(ArenaManager->GetArena(0));
+	}
+
+	USObstacleManager* NewObstacleManager = NewObject<USObstacleManager>(this);
+	NewObstacleManager->EnvironmentCenter = Arena.Center;
+	NewObstacleManager->EnvironmentBounds = ResetBounds;
+	NewObstacleManager->MaxObstacles = MaxObstacles;
+	NewObstacleManager->MinObstacleSize = MinObstacleSize;
+	NewObstacleManager->MaxObstacleSize = MaxObstacleSize;
+	NewObstacleManager->bUseInstancedObstacles = bUseInstancedObstacles;
+	NewObstacleManager->SetRandomSeed(ObstacleRandomSeed + ArenaObstacleManagers.Num()); // Distinct, reproducible layouts per arena
+	if (bIsPrimaryArena)
+	{
+		NewObstacleManager->FindAndSetLocationVolume(); // Try to find LocationVolume
+		ObstacleManager = NewObstacleManager;
+	}
+
+	// After the volume, the library's region is checked against the one its layouts will be placed in
+	NewObstacleManager->SetLayoutLibrary(ObstacleLayoutLibrary);
+
+	// Tiled reset bounds are flat, the obstacles need a height of their own to block agents, rays and movement.
+	// Set before the mode, which places a Static layout right away
+	if (!bIsPrimaryArena || NewObstacleManager->GetObstacleHeight() <= 0.0f)
+	{
+		const float PrimaryHeight = !bIsPrimaryArena && ObstacleManager ? ObstacleManager->GetObstacleHeight() : 0.0f;
+		NewObstacleManager->ObstacleHeight = PrimaryHeight > 0.0f ? PrimaryHeight : ObstacleHeight;
+	}
+	NewObstacleManager->SetObstacleMode(ObstacleMode); // Set the stored mode
+	// Don't initialize obstacles here - let the mode-specific logic handle it
+
+	Arena.ObstacleManager = NewObstacleManager;
+	ArenaObstacleManagers.Add(NewObstacleManager);
+	RegisterDefaultObstacleManager(Arena);
+	return NewObstacleManager;
+}
+
+void USCharacterTrainingEnvironment::RegisterDefaultObstacleManager(const FSCharacterArena& Arena)
+{
+	// Observations look up obstacles through the manager component, which only knows the tiled arenas
+	USCharacterManagerComponent* ArenaManager = Cast<USCharacterManagerComponent>(Manager);
+	if (ArenaManager && &Arena == &DefaultArena)
+	{
+		ArenaManager->SetDefaultObstacleManager(Arena.ObstacleManager);
+	}
+}
+
+bool USCharacterTrainingEnvironment::SetObstacleLayoutLibrary(const FString& Filename)
+{
+	TSharedPtr<FSObstacleLayoutLibrary> Library = MakeShared<FSObstacleLayoutLibrary>();
+	if (!Library->Open(Filename))
+	{
+		return false;
+	}
+
+	const FSObstacleLayoutFileHeader& Header = Library->GetHeader();
+	UE_LOG(LogTemp, Log, TEXT("SCharacterTrainingEnvironment: Using obstacle layout library %s - %d layouts of %d obstacles, %d spawn points each, seed %d"),
+		*Filename, Header.LayoutNum, Header.ObstaclesPerLayout, Header.SpawnPointsPerLayout, Header.Seed);
+
+	ObstacleLayoutLibrary = Library;
+	for (USObstacleManager* ArenaObstacles : ArenaObstacleManagers)
+	{
+		ArenaObstacles->SetLayoutLibrary(ObstacleLayoutLibrary);
+	}
+	return true;
+}
+
+void USCharacterTrainingEnvironment::ConfigureObstacles(bool bUse, int32 MaxObs, float MinSize, float MaxSize, EObstacleMode Mode, bool bInstanced)
 {
 	bUseObstacles = bUse;
 	MaxObstacles = MaxObs;
 	MinObstacleSize = MinSize;
 	MaxObstacleSize = MaxSize;
 	ObstacleMode = Mode; // Store the mode for later use
+	bUseInstancedObstacles = bInstanced;
 	
-	// Update obstacle manager if it exists
-	if (ObstacleManager)
+	// Update obstacle managers if they exist
+	for (USObstacleManager* ArenaObstacles : ArenaObstacleManagers)
 	{
-		ObstacleManager->MaxObstacles = MaxObs;
-		ObstacleManager->MinObstacleSize = MinSize;
-		ObstacleManager->MaxObstacleSize = MaxSize;
-		ObstacleManager->SetObstacleMode(Mode);
+		if (ArenaObstacles)
+		{
+			ArenaObstacles->MaxObstacles = MaxObs;
+			ArenaObstacles->MinObstacleSize = MinSize;
+			ArenaObstacles->MaxObstacleSize = MaxSize;
+			ArenaObstacles->bUseInstancedObstacles = bInstanced;
+			ArenaObstacles->SetObstacleMode(Mode);
+		}
 	}
 	
 	// UE_LOG(LogTemp, Log, TEXT("SCharacterTrainingEnvironment: Obstacles configured - Use: %s, Max: %d, MinSize: %f, MaxSize: %f, Mode: %s"), 
@@ -5,10 +5,50 @@
 #include "CoreMinimal.h"
 #include "LearningAgentsTrainingEnvironment.h"
 #include "Learning/ObstacleTypes.h"
+#include "Learning/SCharacterPointMassSim.h"
+#include "SCharacterManagerComponent.h"
 #include "SCharacterTrainingEnvironment.generated.h"
 
 class ASTargetActor;
 class USObstacleManager;
+class FSObstacleLayoutLibrary;
+
+/**
+ * Structure-of-arrays snapshot of all agents evaluated in one reward/completion pass
+ */
+struct FSCharacterEnvironmentBatch
+{
+	enum EAgentFlags : uint8
+	{
+		Valid			= 1 << 0,
+		Dead			= 1 << 1,
+		Blocked			= 1 << 2,
+		Reached			= 1 << 3,
+		OutOfBounds		= 1 << 4
+	};
+
+	TArray<float> LocationX;
+	TArray<float> LocationY;
+	TArray<float> LocationZ;
+	TArray<float> ForwardX;
+	TArray<float> ForwardY;
+	TArray<float> ForwardZ;
+	TArray<float> TargetX;
+	TArray<float> TargetY;
+	TArray<float> TargetZ;
+	TArray<float> CenterX;
+	TArray<float> CenterY;
+	TArray<const USObstacleManager*> ObstacleManagers;
+	TArray<float> ReachDistances;
+	TArray<float> Distances;
+	TArray<uint8> Flags;
+
+	// Resize every column without shrinking the underlying allocations
+	void SetNum(const int32 Num);
+
+	// Preallocate every column for the given agent count
+	void Reserve(const int32 Num);
+};
 
 /**
  * Training environment for SCharacter learning to move to target
@@ -21,9 +61,16 @@ class COOPGAMEFLEEP_API USCharacterTrainingEnvironment : public ULearningAgentsT
 public:
 	USCharacterTrainingEnvironment();
 
-	virtual void GatherAgentReward_Implementation(float& OutReward, const int32 AgentId) override;
-	virtual void GatherAgentCompletion_Implementation(ELearningAgentsCompletion& OutCompletion, const int32 AgentId) override;
+	virtual void GatherAgentRewards_Implementation(TArray<float>& OutRewards, const TArray<int32>& AgentIds) override;
+	virtual void GatherAgentCompletions_Implementation(TArray<ELearningAgentsCompletion>& OutCompletions, const TArray<int32>& AgentIds) override;
 	virtual void ResetAgentEpisode_Implementation(const int32 AgentId) override;
+	virtual void ResetAgentEpisodes_Implementation(const TArray<int32>& AgentIds) override;
+
+	// Bank one simulation step's rewards while the agents hold their last action, paid out with the next decision's rewards
+	void AccumulateHeldRewards(const TArray<int32>& AgentIds);
+
+	// Start a new simulation step, the next reward or completion gather takes a fresh snapshot that the other reuses
+	void BeginStep() { StepCounter++; }
 
 	// Target actor reference
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Learning")
@@ -49,9 +96,17 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rewards")
 	float TimeStepPenalty = -0.01f;
 
+	// Episode limit in simulation steps, however many of them each decision is held for
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rewards")
 	float MaxEpisodeLength = 1000.0f;
 
+	// Simulation steps each decision is held for, set by the manager
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rewards", meta = (ClampMin = 1))
+	int32 DecisionInterval = 1;
+
+	// MaxEpisodeLength in decisions, which is what the episode step counters count
+	int32 GetMaxEpisodeDecisions() const;
+
 	// Reset bounds for character and target
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Environment")
 	FVector ResetCenter = FVector::ZeroVector;
@@ -82,12 +137,95 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Obstacles")
 	EObstacleMode ObstacleMode = EObstacleMode::Static;
 
+	// Height of generated obstacles when the placement region has none, e.g. a tiled arena's flat reset bounds.
+	// Tiled arenas copy the primary arena's obstacle height when it has one
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Obstacles", meta = (ClampMin = "1.0"))
+	float ObstacleHeight = 300.0f;
+
+	// Seed of the first arena's obstacle layouts, later arenas count up from it
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Obstacles")
+	int32 ObstacleRandomSeed = 1234;
+
+	// In Dynamic mode, how far around a partial reset's new starts the obstacles are resampled
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Obstacles", meta = (ClampMin = "0.0"))
+	float DynamicResetRegionRadius = 1000.0f;
+
+	// Draw each arena's obstacles as instances of one mesh instead of one actor per obstacle
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Obstacles")
+	bool bUseInstancedObstacles = false;
+
 	// Function to configure obstacles from external source
 	UFUNCTION(BlueprintCallable, Category = "Obstacles")
-	void ConfigureObstacles(bool bUse, int32 MaxObs, float MinSize, float MaxSize, EObstacleMode Mode);
+	void ConfigureObstacles(bool bUse, int32 MaxObs, float MinSize, float MaxSize, EObstacleMode Mode, bool bInstanced = false);
+
+	// Map a pre-generated obstacle layout library and share it with every arena's obstacle manager
+	bool SetObstacleLayoutLibrary(const FString& Filename);
+
+	// Reward terms from the settings above
+	FSCharacterTaskRewards GetTaskRewards() const;
+
+	// The same task for the engine-free point-mass simulator
+	FSCharacterPointMassSimSettings MakePointMassSimSettings() const;
+
+	// Obstacle manager of the arena, created on first use
+	USObstacleManager* GetOrCreateObstacleManager(FSCharacterArena& Arena);
 
 private:
-	// Store previous distances for reward calculation
-	TMap<int32, float> PreviousDistances;
-	TMap<int32, int32> EpisodeSteps;
+	// Arena the agent is assigned to, or a single arena covering the reset region when not tiled
+	FSCharacterArena& GetAgentArena(USCharacterManagerComponent* ArenaManager, const int32 AgentId);
+
+	// Target the agent chases, its own one when tiled, otherwise the shared configured target
+	ASTargetActor* GetAgentTarget(const USCharacterManagerComponent* ArenaManager, const int32 AgentId) const;
+
+	// Reset the given agents of one arena, rebuilding its layout (or the part around the reset agents) at most once and moving each agent's own target
+	void ResetArenaAgents(FSCharacterArena& Arena, const TArray<int32>& AgentIds);
+
+	// Share the untiled arena's obstacles with the manager component
+	void RegisterDefaultObstacleManager(const FSCharacterArena& Arena);
+
+	// Stand-in arena used when the manager has no tiles set up
+	UPROPERTY()
+	FSCharacterArena DefaultArena;
+
+	// Every obstacle manager created for an arena
+	UPROPERTY()
+	TArray<USObstacleManager*> ArenaObstacleManagers;
+
+	// Layouts shared by all arenas when running with -ObstacleLayoutLibrary
+	TSharedPtr<FSObstacleLayoutLibrary> ObstacleLayoutLibrary;
+
+	// Size the dense per-agent state from the manager's maximum agent count
+	void EnsureAgentState();
+
+	// Read every agent's transform into the batch snapshot and run the distance/bounds kernel and the obstacle check,
+	// at most once per step for the same agents
+	void GatherEnvironmentSnapshot(const TArray<int32>& AgentIds);
+
+	// Reward of the current step for every agent of the snapshot
+	void EvaluateStepRewards(const TArray<int32>& AgentIds, TArrayView<float> OutRewards);
+
+	// Previous distance per AgentId for reward calculation, negative when unknown
+	TArray<float> PreviousDistances;
+
+	// Steps taken in the current episode per AgentId
+	TArray<int32> EpisodeSteps;
+
+	// Rewards banked per AgentId since the last decision, and the episode-ending flags (Reached, OutOfBounds, Dead)
+	// raised in between, which end the episode at the next decision even if the agent has recovered by then
+	TArray<float> HeldRewards;
+	TArray<uint8> HeldEndFlags;
+	TArray<float> HeldStepRewards;
+
+	// Reused between steps so evaluation does not reallocate
+	FSCharacterEnvironmentBatch EnvironmentBatch;
+
+	// Steps begun so far, and the step and agents the current snapshot was taken for
+	uint64 StepCounter = 0;
+	uint64 SnapshotStep = MAX_uint64;
+	TArray<int32> SnapshotAgentIds;
+
+	// Scratch for the batched obstacle penalty query, reused every step
+	TArray<int32> BlockedQueryIndices;
+	TArray<FVector> BlockedQueryLocations;
+	TArray<bool> BlockedQueryResults;
 }; 
\ No newline at end of file
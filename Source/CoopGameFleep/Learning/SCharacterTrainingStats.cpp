@@ -0,0 +1,95 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Learning/SCharacterTrainingStats.h"
+#include "HAL/IConsoleManager.h"
+
+DEFINE_STAT(STAT_CoopTrainingStep);
+DEFINE_STAT(STAT_CoopGatherObservations);
+DEFINE_STAT(STAT_CoopPerformActions);
+DEFINE_STAT(STAT_CoopGatherRewards);
+DEFINE_STAT(STAT_CoopGatherCompletions);
+DEFINE_STAT(STAT_CoopResetEpisodes);
+DEFINE_STAT(STAT_CoopObstacleRegeneration);
+DEFINE_STAT(STAT_CoopSimStep);
+
+CSV_DEFINE_CATEGORY_MODULE(COOPGAMEFLEEP_API, CoopTraining, true);
+
+static int32 LogTrainingEvents = 0;
+FAutoConsoleVariableRef CVarLogTrainingEvents(TEXT("COOP.LogTrainingEvents"), LogTrainingEvents, TEXT("Log every reset, completion and reward event instead of only the per-iteration summary"), ECVF_Default);
+
+FSCharacterTrainingStats& FSCharacterTrainingStats::Get()
+{
+	static FSCharacterTrainingStats Stats;
+	return Stats;
+}
+
+bool FSCharacterTrainingStats::IsVerbose()
+{
+	return LogTrainingEvents != 0;
+}
+
+void FSCharacterTrainingStats::RecordEpisodeEnd(const ESCharacterEpisodeEnd Reason, const int32 EpisodeSteps, const int32 MaxEpisodeSteps)
+{
+	EpisodeEnds[(int32)Reason]++;
+	EpisodeStepSum += EpisodeSteps;
+
+	const int32 Bucket = MaxEpisodeSteps > 0 ? (EpisodeSteps * EpisodeLengthBucketNum) / MaxEpisodeSteps : 0;
+	EpisodeLengthHistogram[FMath::Clamp(Bucket, 0, EpisodeLengthBucketNum - 1)]++;
+}
+
+FString FSCharacterTrainingStats::ToSummaryString() const
+{
+	int32 EpisodeNum = 0;
+	for (const int32 Count : EpisodeEnds)
+	{
+		EpisodeNum += Count;
+	}
+
+	FString Histogram;
+	for (int32 Bucket = 0; Bucket < EpisodeLengthBucketNum; Bucket++)
+	{
+		Histogram += FString::Printf(Bucket == 0 ? TEXT("%d") : TEXT(",%d"), EpisodeLengthHistogram[Bucket]);
+	}
+
+	// Milliseconds spent per stage over the iteration, the trainer share is what the step spends outside our callbacks
+	auto StageMs = [this](const ESCharacterTrainingStage Stage) { return StageSeconds[(int32)Stage] * 1000.0; };
+	const double TrainerMs = StageMs(ESCharacterTrainingStage::TrainingStep) -
+		StageMs(ESCharacterTrainingStage::GatherObservations) - StageMs(ESCharacterTrainingStage::PerformActions) -
+		StageMs(ESCharacterTrainingStage::GatherRewards) - StageMs(ESCharacterTrainingStage::GatherCompletions) -
+		StageMs(ESCharacterTrainingStage::ResetEpisodes);
+
+	const FString Timings = FString::Printf(TEXT("ms: frames=%d frame=%.1f step=%.1f obs=%.1f act=%.1f rew=%.1f done=%.1f reset=%.1f obst=%.1f sim=%.1f trainer=%.1f"),
+		StageCalls[(int32)ESCharacterTrainingStage::Frame],
+		StageMs(ESCharacterTrainingStage::Frame),
+		StageMs(ESCharacterTrainingStage::TrainingStep),
+		StageMs(ESCharacterTrainingStage::GatherObservations),
+		StageMs(ESCharacterTrainingStage::PerformActions),
+		StageMs(ESCharacterTrainingStage::GatherRewards),
+		StageMs(ESCharacterTrainingStage::GatherCompletions),
+		StageMs(ESCharacterTrainingStage::ResetEpisodes),
+		StageMs(ESCharacterTrainingStage::ObstacleRegeneration),
+		StageMs(ESCharacterTrainingStage::SimStep),
+		FMath::Max(TrainerMs, 0.0));
+
+	return FString::Printf(TEXT("steps=%lld reward=%.3f episodes=%d reached=%d maxsteps=%d bounds=%d died=%d invalid=%d meanlen=%.1f lenhist=[%s] resets=%d targets=%d health=%d ammo=%d %s"),
+		AgentSteps,
+		AgentSteps > 0 ? RewardSum / AgentSteps : 0.0,
+		EpisodeNum,
+		EpisodeEnds[(int32)ESCharacterEpisodeEnd::ReachedTarget],
+		EpisodeEnds[(int32)ESCharacterEpisodeEnd::MaxSteps],
+		EpisodeEnds[(int32)ESCharacterEpisodeEnd::OutOfBounds],
+		EpisodeEnds[(int32)ESCharacterEpisodeEnd::Died],
+		EpisodeEnds[(int32)ESCharacterEpisodeEnd::Invalid],
+		EpisodeNum > 0 ? (double)EpisodeStepSum / EpisodeNum : 0.0,
+		*Histogram,
+		AgentResets,
+		TargetResets,
+		HealthResets,
+		AmmoChanges,
+		*Timings);
+}
+
+void FSCharacterTrainingStats::Reset()
+{
+	*this = FSCharacterTrainingStats();
+}
@@ -84,6 +84,18 @@ void ASObstacleActor::InitializeObstacle(float Width, float Height, float Depth)
 	UpdateCollisionBox();
 }
 
+void ASObstacleActor::SetObstacleActive(bool bActive)
+{
+	if (bObstacleActive == bActive)
+	{
+		return;
+	}
+
+	bObstacleActive = bActive;
+	SetActorHiddenInGame(!bActive);
+	SetActorEnableCollision(bActive);
+}
+
 void ASObstacleActor::UpdateCollisionBox()
 {
 	if (CollisionBox)
@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Learning/SObstacleFieldActor.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "UObject/ConstructorHelpers.h"
+
+ASObstacleFieldActor::ASObstacleFieldActor()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	ObstacleInstances = CreateDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("ObstacleInstances"));
+	RootComponent = ObstacleInstances;
+
+	// Same collision as ASObstacleActor's box, but one body per instance inside a single component
+	ObstacleInstances->SetMobility(EComponentMobility::Movable);
+	ObstacleInstances->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+	ObstacleInstances->SetCollisionResponseToAllChannels(ECR_Block);
+	ObstacleInstances->SetCanEverAffectNavigation(false);
+
+	static ConstructorHelpers::FObjectFinder<UStaticMesh> CubeMesh(TEXT("/Engine/BasicShapes/Cube"));
+	if (CubeMesh.Succeeded())
+	{
+		ObstacleInstances->SetStaticMesh(CubeMesh.Object);
+	}
+}
+
+void ASObstacleFieldActor::SetObstacles(TArrayView<const FBox> Boxes)
+{
+	const int32 OldNum = Centers.Num();
+	const int32 NewNum = Boxes.Num();
+
+	Centers.SetNumUninitialized(NewNum);
+	HalfExtents.SetNumUninitialized(NewNum);
+
+	// The basic cube is 100 units on each side, centered on its origin
+	TArray<FTransform> Transforms;
+	Transforms.SetNumUninitialized(NewNum);
+	for (int32 Index = 0; Index < NewNum; Index++)
+	{
+		const FVector Center = Boxes[Index].GetCenter();
+		const FVector Extent = Boxes[Index].GetExtent();
+		Centers[Index] = FVector3f(Center);
+		HalfExtents[Index] = FVector3f(Extent);
+		Transforms[Index] = FTransform(FQuat::Identity, Center, Extent / 50.0);
+	}
+
+	const int32 ReusedNum = FMath::Min(OldNum, NewNum);
+	if (ReusedNum > 0)
+	{
+		ObstacleInstances->BatchUpdateInstancesTransforms(0, MakeArrayView(Transforms.GetData(), ReusedNum), true, NewNum <= OldNum, true);
+	}
+
+	if (NewNum > OldNum)
+	{
+		ObstacleInstances->AddInstances(TArray<FTransform>(Transforms.GetData() + OldNum, NewNum - OldNum), false, true);
+	}
+	else if (NewNum < OldNum)
+	{
+		TArray<int32> RemovedInstances;
+		for (int32 Index = OldNum - 1; Index >= NewNum; Index--)
+		{
+			RemovedInstances.Add(Index);
+		}
+		ObstacleInstances->RemoveInstances(RemovedInstances);
+	}
+}
+
+bool ASObstacleFieldActor::IsLocationBlocked(const FVector& Location, float AgentRadius) const
+{
+	const FVector3f Point(Location);
+	for (int32 Index = 0; Index < Centers.Num(); Index++)
+	{
+		const FVector3f Offset = (Point - Centers[Index]).GetAbs();
+		const FVector3f Limit = HalfExtents[Index] + FVector3f(AgentRadius);
+		if (Offset.X <= Limit.X && Offset.Y <= Limit.Y && Offset.Z <= Limit.Z)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+FBox ASObstacleFieldActor::GetObstacleBounds(int32 Index) const
+{
+	const FVector Center(Centers[Index]);
+	const FVector HalfExtent(HalfExtents[Index]);
+	return FBox(Center - HalfExtent, Center + HalfExtent);
+}
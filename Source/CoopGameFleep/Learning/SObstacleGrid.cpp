@@ -0,0 +1,364 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Learning/SObstacleGrid.h"
+
+namespace SObstacleGrid
+{
+	// Keeps the cell table small even for very sparse or degenerate layouts
+	static constexpr int32 MaxCellsPerAxis = 512;
+
+	// Past this many boxes a batch query walks the grid cells instead of testing every box
+	static constexpr int32 MaxBoxesPerBatchScan = 256;
+
+	// Stands in for 1 / 0 so axis-aligned rays stay finite in the slab test
+	static constexpr float MaxInvDirection = 1.0e30f;
+
+	// Whether any of the boxes stored four to a register comes within Radius of Location, padding boxes never do
+	static bool OverlapsAnyBox(const FVector& Location, const float Radius,
+		const float* MinX, const float* MinY, const float* MinZ, const float* MaxX, const float* MaxY, const float* MaxZ, const int32 PaddedNum)
+	{
+		// Expanding the location instead of every box: Min - R <= L <= Max + R is L + R >= Min and L - R <= Max
+		const VectorRegister4Float UpperX = VectorSetFloat1((float)Location.X + Radius);
+		const VectorRegister4Float UpperY = VectorSetFloat1((float)Location.Y + Radius);
+		const VectorRegister4Float UpperZ = VectorSetFloat1((float)Location.Z + Radius);
+		const VectorRegister4Float LowerX = VectorSetFloat1((float)Location.X - Radius);
+		const VectorRegister4Float LowerY = VectorSetFloat1((float)Location.Y - Radius);
+		const VectorRegister4Float LowerZ = VectorSetFloat1((float)Location.Z - Radius);
+
+		for (int32 BoxIndex = 0; BoxIndex < PaddedNum; BoxIndex += 4)
+		{
+			VectorRegister4Float Inside = VectorBitwiseAnd(
+				VectorCompareGE(UpperX, VectorLoadAligned(MinX + BoxIndex)),
+				VectorCompareLE(LowerX, VectorLoadAligned(MaxX + BoxIndex)));
+			Inside = VectorBitwiseAnd(Inside, VectorCompareGE(UpperY, VectorLoadAligned(MinY + BoxIndex)));
+			Inside = VectorBitwiseAnd(Inside, VectorCompareLE(LowerY, VectorLoadAligned(MaxY + BoxIndex)));
+			Inside = VectorBitwiseAnd(Inside, VectorCompareGE(UpperZ, VectorLoadAligned(MinZ + BoxIndex)));
+			Inside = VectorBitwiseAnd(Inside, VectorCompareLE(LowerZ, VectorLoadAligned(MaxZ + BoxIndex)));
+			if (VectorMaskBits(Inside) != 0)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Nearest hit of one XY ray against boxes stored four to a register, padded with boxes that span no height
+	static float TraceRay(const FVector2f& Origin, const float OriginZ, const FVector2f& Direction, const float MaxDistance,
+		const float* MinX, const float* MinY, const float* MinZ, const float* MaxX, const float* MaxY, const float* MaxZ, const int32 PaddedNum)
+	{
+		const VectorRegister4Float OriginX = VectorSetFloat1(Origin.X);
+		const VectorRegister4Float OriginY = VectorSetFloat1(Origin.Y);
+		const VectorRegister4Float Height = VectorSetFloat1(OriginZ);
+		const VectorRegister4Float InvDirectionX = VectorSetFloat1(Direction.X != 0.0f ? 1.0f / Direction.X : MaxInvDirection);
+		const VectorRegister4Float InvDirectionY = VectorSetFloat1(Direction.Y != 0.0f ? 1.0f / Direction.Y : MaxInvDirection);
+		const VectorRegister4Float Miss = VectorSetFloat1(MaxDistance);
+
+		VectorRegister4Float Nearest = Miss;
+		for (int32 BoxIndex = 0; BoxIndex < PaddedNum; BoxIndex += 4)
+		{
+			// Slab test: the ray is inside the box between the last entry and the first exit over both axes
+			const VectorRegister4Float EntryX = VectorMultiply(VectorSubtract(VectorLoad(MinX + BoxIndex), OriginX), InvDirectionX);
+			const VectorRegister4Float ExitX = VectorMultiply(VectorSubtract(VectorLoad(MaxX + BoxIndex), OriginX), InvDirectionX);
+			const VectorRegister4Float EntryY = VectorMultiply(VectorSubtract(VectorLoad(MinY + BoxIndex), OriginY), InvDirectionY);
+			const VectorRegister4Float ExitY = VectorMultiply(VectorSubtract(VectorLoad(MaxY + BoxIndex), OriginY), InvDirectionY);
+
+			const VectorRegister4Float Near = VectorMax(VectorMax(VectorMin(EntryX, ExitX), VectorMin(EntryY, ExitY)), VectorZeroFloat());
+			const VectorRegister4Float Far = VectorMin(VectorMax(EntryX, ExitX), VectorMax(EntryY, ExitY));
+
+			VectorRegister4Float Hit = VectorCompareLE(Near, Far);
+			Hit = VectorBitwiseAnd(Hit, VectorCompareLE(VectorLoad(MinZ + BoxIndex), Height));
+			Hit = VectorBitwiseAnd(Hit, VectorCompareGE(VectorLoad(MaxZ + BoxIndex), Height));
+			Nearest = VectorMin(Nearest, VectorSelect(Hit, Near, Miss));
+		}
+
+		alignas(16) float Distances[4];
+		VectorStoreAligned(Nearest, Distances);
+		return FMath::Min(FMath::Min(Distances[0], Distances[1]), FMath::Min(Distances[2], Distances[3]));
+	}
+}
+
+void FSObstacleGrid::Build(TArrayView<const FBox> InBoxes)
+{
+	Reset();
+	Boxes.Append(InBoxes.GetData(), InBoxes.Num());
+	if (Boxes.Num() == 0)
+	{
+		return;
+	}
+
+	// Padding boxes have Min above Max, so no location is ever inside them
+	const int32 PaddedNum = Align(Boxes.Num(), 4);
+	BoxMinX.Init(UE_BIG_NUMBER, PaddedNum);
+	BoxMinY.Init(UE_BIG_NUMBER, PaddedNum);
+	BoxMinZ.Init(UE_BIG_NUMBER, PaddedNum);
+	BoxMaxX.Init(-UE_BIG_NUMBER, PaddedNum);
+	BoxMaxY.Init(-UE_BIG_NUMBER, PaddedNum);
+	BoxMaxZ.Init(-UE_BIG_NUMBER, PaddedNum);
+	for (int32 BoxIndex = 0; BoxIndex < Boxes.Num(); BoxIndex++)
+	{
+		const FBox& Box = Boxes[BoxIndex];
+		BoxMinX[BoxIndex] = (float)Box.Min.X;
+		BoxMinY[BoxIndex] = (float)Box.Min.Y;
+		BoxMinZ[BoxIndex] = (float)Box.Min.Z;
+		BoxMaxX[BoxIndex] = (float)Box.Max.X;
+		BoxMaxY[BoxIndex] = (float)Box.Max.Y;
+		BoxMaxZ[BoxIndex] = (float)Box.Max.Z;
+	}
+
+	double SizeSum = 0.0;
+	for (const FBox& Box : Boxes)
+	{
+		Bounds += Box;
+		const FVector Size = Box.GetSize();
+		SizeSum += FMath::Max(Size.X, Size.Y);
+	}
+
+	// About one box per cell: no smaller than a typical box, no finer than the layout's density needs
+	const FVector BoundsSize = Bounds.GetSize();
+	double CellSize = FMath::Max(SizeSum / Boxes.Num(), FMath::Sqrt(BoundsSize.X * BoundsSize.Y / Boxes.Num()));
+	CellSize = FMath::Max3(CellSize, BoundsSize.X / SObstacleGrid::MaxCellsPerAxis, BoundsSize.Y / SObstacleGrid::MaxCellsPerAxis);
+	CellSize = FMath::Max(CellSize, 1.0);
+
+	InvCellSize = 1.0 / CellSize;
+	CellNumX = FMath::Clamp(FMath::CeilToInt(BoundsSize.X * InvCellSize), 1, SObstacleGrid::MaxCellsPerAxis);
+	CellNumY = FMath::Clamp(FMath::CeilToInt(BoundsSize.Y * InvCellSize), 1, SObstacleGrid::MaxCellsPerAxis);
+
+	// Count boxes per cell, then turn the counts into row offsets
+	CellStarts.SetNumZeroed(CellNumX * CellNumY + 1);
+	for (const FBox& Box : Boxes)
+	{
+		const int32 MinX = CellCoord(Box.Min.X, Bounds.Min.X, CellNumX);
+		const int32 MaxX = CellCoord(Box.Max.X, Bounds.Min.X, CellNumX);
+		const int32 MinY = CellCoord(Box.Min.Y, Bounds.Min.Y, CellNumY);
+		const int32 MaxY = CellCoord(Box.Max.Y, Bounds.Min.Y, CellNumY);
+		for (int32 Y = MinY; Y <= MaxY; Y++)
+		{
+			for (int32 X = MinX; X <= MaxX; X++)
+			{
+				CellStarts[Y * CellNumX + X + 1]++;
+			}
+		}
+	}
+
+	for (int32 Cell = 1; Cell < CellStarts.Num(); Cell++)
+	{
+		CellStarts[Cell] += CellStarts[Cell - 1];
+	}
+
+	BoxIndices.SetNumUninitialized(CellStarts.Last());
+	TArray<int32> Cursors(CellStarts.GetData(), CellNumX * CellNumY);
+	for (int32 BoxIndex = 0; BoxIndex < Boxes.Num(); BoxIndex++)
+	{
+		const FBox& Box = Boxes[BoxIndex];
+		const int32 MinX = CellCoord(Box.Min.X, Bounds.Min.X, CellNumX);
+		const int32 MaxX = CellCoord(Box.Max.X, Bounds.Min.X, CellNumX);
+		const int32 MinY = CellCoord(Box.Min.Y, Bounds.Min.Y, CellNumY);
+		const int32 MaxY = CellCoord(Box.Max.Y, Bounds.Min.Y, CellNumY);
+		for (int32 Y = MinY; Y <= MaxY; Y++)
+		{
+			for (int32 X = MinX; X <= MaxX; X++)
+			{
+				BoxIndices[Cursors[Y * CellNumX + X]++] = BoxIndex;
+			}
+		}
+	}
+
+	// Copy every cell's boxes out into padded lanes, empty cells take no lanes
+	const int32 CellNum = CellNumX * CellNumY;
+	CellBoxStarts.SetNumUninitialized(CellNum + 1);
+	CellBoxStarts[0] = 0;
+	for (int32 Cell = 0; Cell < CellNum; Cell++)
+	{
+		CellBoxStarts[Cell + 1] = CellBoxStarts[Cell] + Align(CellStarts[Cell + 1] - CellStarts[Cell], 4);
+	}
+
+	const int32 LaneNum = CellBoxStarts.Last();
+	CellBoxMinX.Init(UE_BIG_NUMBER, LaneNum);
+	CellBoxMinY.Init(UE_BIG_NUMBER, LaneNum);
+	CellBoxMinZ.Init(UE_BIG_NUMBER, LaneNum);
+	CellBoxMaxX.Init(-UE_BIG_NUMBER, LaneNum);
+	CellBoxMaxY.Init(-UE_BIG_NUMBER, LaneNum);
+	CellBoxMaxZ.Init(-UE_BIG_NUMBER, LaneNum);
+	for (int32 Cell = 0; Cell < CellNum; Cell++)
+	{
+		for (int32 Entry = CellStarts[Cell]; Entry < CellStarts[Cell + 1]; Entry++)
+		{
+			const int32 Lane = CellBoxStarts[Cell] + Entry - CellStarts[Cell];
+			const int32 BoxIndex = BoxIndices[Entry];
+			CellBoxMinX[Lane] = BoxMinX[BoxIndex];
+			CellBoxMinY[Lane] = BoxMinY[BoxIndex];
+			CellBoxMinZ[Lane] = BoxMinZ[BoxIndex];
+			CellBoxMaxX[Lane] = BoxMaxX[BoxIndex];
+			CellBoxMaxY[Lane] = BoxMaxY[BoxIndex];
+			CellBoxMaxZ[Lane] = BoxMaxZ[BoxIndex];
+		}
+	}
+}
+
+void FSObstacleGrid::Reset()
+{
+	Boxes.Reset();
+	BoxMinX.Reset();
+	BoxMinY.Reset();
+	BoxMinZ.Reset();
+	BoxMaxX.Reset();
+	BoxMaxY.Reset();
+	BoxMaxZ.Reset();
+	CellStarts.Reset();
+	BoxIndices.Reset();
+	CellBoxStarts.Reset();
+	CellBoxMinX.Reset();
+	CellBoxMinY.Reset();
+	CellBoxMinZ.Reset();
+	CellBoxMaxX.Reset();
+	CellBoxMaxY.Reset();
+	CellBoxMaxZ.Reset();
+	Bounds = FBox(ForceInit);
+	InvCellSize = 0.0;
+	CellNumX = 0;
+	CellNumY = 0;
+}
+
+bool FSObstacleGrid::IsLocationBlocked(const FVector& Location, const float Radius) const
+{
+	if (Boxes.Num() == 0 ||
+		Location.X < Bounds.Min.X - Radius || Location.X > Bounds.Max.X + Radius ||
+		Location.Y < Bounds.Min.Y - Radius || Location.Y > Bounds.Max.Y + Radius ||
+		Location.Z < Bounds.Min.Z - Radius || Location.Z > Bounds.Max.Z + Radius)
+	{
+		return false;
+	}
+
+	// Only the cells the query square touches can hold a box within Radius
+	const int32 MinX = CellCoord(Location.X - Radius, Bounds.Min.X, CellNumX);
+	const int32 MaxX = CellCoord(Location.X + Radius, Bounds.Min.X, CellNumX);
+	const int32 MinY = CellCoord(Location.Y - Radius, Bounds.Min.Y, CellNumY);
+	const int32 MaxY = CellCoord(Location.Y + Radius, Bounds.Min.Y, CellNumY);
+
+	for (int32 Y = MinY; Y <= MaxY; Y++)
+	{
+		for (int32 X = MinX; X <= MaxX; X++)
+		{
+			const int32 Cell = Y * CellNumX + X;
+			for (int32 Entry = CellStarts[Cell]; Entry < CellStarts[Cell + 1]; Entry++)
+			{
+				const FBox& Box = Boxes[BoxIndices[Entry]];
+				if (Location.X >= Box.Min.X - Radius && Location.X <= Box.Max.X + Radius &&
+					Location.Y >= Box.Min.Y - Radius && Location.Y <= Box.Max.Y + Radius &&
+					Location.Z >= Box.Min.Z - Radius && Location.Z <= Box.Max.Z + Radius)
+				{
+					return true;
+				}
+			}
+		}
+	}
+
+	return false;
+}
+
+void FSObstacleGrid::AreLocationsBlocked(TArrayView<const FVector> Locations, const float Radius, TArrayView<bool> OutBlocked) const
+{
+	check(OutBlocked.Num() == Locations.Num());
+
+	// Every box of a small layout fits in a few registers
+	if (Boxes.Num() <= SObstacleGrid::MaxBoxesPerBatchScan)
+	{
+		for (int32 Index = 0; Index < Locations.Num(); Index++)
+		{
+			OutBlocked[Index] = SObstacleGrid::OverlapsAnyBox(Locations[Index], Radius,
+				BoxMinX.GetData(), BoxMinY.GetData(), BoxMinZ.GetData(), BoxMaxX.GetData(), BoxMaxY.GetData(), BoxMaxZ.GetData(), BoxMinX.Num());
+		}
+		return;
+	}
+
+	// Large layouts: the same vector test over the boxes of the cells the query square touches
+	for (int32 Index = 0; Index < Locations.Num(); Index++)
+	{
+		const FVector& Location = Locations[Index];
+		if (Location.X < Bounds.Min.X - Radius || Location.X > Bounds.Max.X + Radius ||
+			Location.Y < Bounds.Min.Y - Radius || Location.Y > Bounds.Max.Y + Radius ||
+			Location.Z < Bounds.Min.Z - Radius || Location.Z > Bounds.Max.Z + Radius)
+		{
+			OutBlocked[Index] = false;
+			continue;
+		}
+
+		const int32 MinX = CellCoord(Location.X - Radius, Bounds.Min.X, CellNumX);
+		const int32 MaxX = CellCoord(Location.X + Radius, Bounds.Min.X, CellNumX);
+		const int32 MinY = CellCoord(Location.Y - Radius, Bounds.Min.Y, CellNumY);
+		const int32 MaxY = CellCoord(Location.Y + Radius, Bounds.Min.Y, CellNumY);
+
+		bool bBlocked = false;
+		for (int32 Y = MinY; Y <= MaxY && !bBlocked; Y++)
+		{
+			for (int32 X = MinX; X <= MaxX && !bBlocked; X++)
+			{
+				const int32 Cell = Y * CellNumX + X;
+				const int32 Lane = CellBoxStarts[Cell];
+				bBlocked = SObstacleGrid::OverlapsAnyBox(Location, Radius,
+					CellBoxMinX.GetData() + Lane, CellBoxMinY.GetData() + Lane, CellBoxMinZ.GetData() + Lane,
+					CellBoxMaxX.GetData() + Lane, CellBoxMaxY.GetData() + Lane, CellBoxMaxZ.GetData() + Lane, CellBoxStarts[Cell + 1] - Lane);
+			}
+		}
+		OutBlocked[Index] = bBlocked;
+	}
+}
+
+void FSObstacleGrid::TraceRays(const FVector& Origin, TArrayView<const FVector2f> Directions, const float MaxDistance, TArrayView<float> OutDistances) const
+{
+	check(OutDistances.Num() == Directions.Num());
+
+	for (float& Distance : OutDistances)
+	{
+		Distance = MaxDistance;
+	}
+
+	// Nothing to hit when no box is within reach of the fan
+	if (Boxes.Num() == 0 ||
+		Origin.X < Bounds.Min.X - MaxDistance || Origin.X > Bounds.Max.X + MaxDistance ||
+		Origin.Y < Bounds.Min.Y - MaxDistance || Origin.Y > Bounds.Max.Y + MaxDistance ||
+		Origin.Z < Bounds.Min.Z || Origin.Z > Bounds.Max.Z)
+	{
+		return;
+	}
+
+	const FVector2f Origin2D(Origin.X, Origin.Y);
+	const float OriginZ = (float)Origin.Z;
+	if (Boxes.Num() <= SObstacleGrid::MaxBoxesPerBatchScan)
+	{
+		for (int32 Ray = 0; Ray < Directions.Num(); Ray++)
+		{
+			OutDistances[Ray] = SObstacleGrid::TraceRay(Origin2D, OriginZ, Directions[Ray], MaxDistance,
+				BoxMinX.GetData(), BoxMinY.GetData(), BoxMinZ.GetData(), BoxMaxX.GetData(), BoxMaxY.GetData(), BoxMaxZ.GetData(), BoxMinX.Num());
+		}
+		return;
+	}
+
+	// Large layouts: the boxes of every cell the fan can reach, a box listed in several cells just hits at the same distance again
+	const int32 MinCellX = CellCoord(Origin.X - MaxDistance, Bounds.Min.X, CellNumX);
+	const int32 MaxCellX = CellCoord(Origin.X + MaxDistance, Bounds.Min.X, CellNumX);
+	const int32 MinCellY = CellCoord(Origin.Y - MaxDistance, Bounds.Min.Y, CellNumY);
+	const int32 MaxCellY = CellCoord(Origin.Y + MaxDistance, Bounds.Min.Y, CellNumY);
+
+	for (int32 Y = MinCellY; Y <= MaxCellY; Y++)
+	{
+		for (int32 X = MinCellX; X <= MaxCellX; X++)
+		{
+			const int32 Cell = Y * CellNumX + X;
+			const int32 Lane = CellBoxStarts[Cell];
+			const int32 LaneNum = CellBoxStarts[Cell + 1] - Lane;
+			if (LaneNum == 0)
+			{
+				continue;
+			}
+
+			// The nearest hit so far is the miss distance, so every cell can only shorten a ray
+			for (int32 Ray = 0; Ray < Directions.Num(); Ray++)
+			{
+				OutDistances[Ray] = SObstacleGrid::TraceRay(Origin2D, OriginZ, Directions[Ray], OutDistances[Ray],
+					CellBoxMinX.GetData() + Lane, CellBoxMinY.GetData() + Lane, CellBoxMinZ.GetData() + Lane,
+					CellBoxMaxX.GetData() + Lane, CellBoxMaxY.GetData() + Lane, CellBoxMaxZ.GetData() + Lane, LaneNum);
+			}
+		}
+	}
+}
@@ -0,0 +1,43 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SObstacleLayoutCommandlet.h"
+#include "Learning/SObstacleLayoutLibrary.h"
+#include "Misc/Paths.h"
+
+USObstacleLayoutCommandlet::USObstacleLayoutCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 USObstacleLayoutCommandlet::Main(const FString& Params)
+{
+	FSObstacleLayoutLibrarySettings Settings;
+	FParse::Value(*Params, TEXT("-Layouts="), Settings.LayoutNum);
+	FParse::Value(*Params, TEXT("-Obstacles="), Settings.ObstaclesPerLayout);
+	FParse::Value(*Params, TEXT("-SpawnPoints="), Settings.SpawnPointsPerLayout);
+	FParse::Value(*Params, TEXT("-Seed="), Settings.Seed);
+	FParse::Value(*Params, TEXT("-ExtentX="), Settings.RegionExtent.X);
+	FParse::Value(*Params, TEXT("-ExtentY="), Settings.RegionExtent.Y);
+	FParse::Value(*Params, TEXT("-MinObstacleSize="), Settings.MinObstacleSize);
+	FParse::Value(*Params, TEXT("-MaxObstacleSize="), Settings.MaxObstacleSize);
+	FParse::Value(*Params, TEXT("-AgentRadius="), Settings.AgentRadius);
+
+	FString Output = FPaths::ProjectSavedDir() / TEXT("ObstacleLayouts.bin");
+	FParse::Value(*Params, TEXT("-Output="), Output);
+
+	UE_LOG(LogTemp, Display, TEXT("SObstacleLayoutCommandlet: Generating %d layouts of %d obstacles and %d spawn points over %sx%s (seed %d)"),
+		Settings.LayoutNum, Settings.ObstaclesPerLayout, Settings.SpawnPointsPerLayout,
+		*FString::SanitizeFloat(Settings.RegionExtent.X * 2.0f), *FString::SanitizeFloat(Settings.RegionExtent.Y * 2.0f), Settings.Seed);
+
+	const int32 Rejected = FSObstacleLayoutLibrary::Generate(Settings, Output);
+	if (Rejected == INDEX_NONE)
+	{
+		return 1;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("SObstacleLayoutCommandlet: Wrote %s (%d candidate layouts rejected)"), *Output, Rejected);
+	return 0;
+}
@@ -0,0 +1,24 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "SObstacleLayoutCommandlet.generated.h"
+
+/**
+ * Writes a library of validated obstacle layouts for -ObstacleLayoutLibrary=
+ *
+ * UnrealEditor-Cmd CoopGameFleep.uproject -run=SObstacleLayout -Output=Saved/ObstacleLayouts.bin -Layouts=4096
+ *     -Obstacles=24 -SpawnPoints=32 -ExtentX=2000 -ExtentY=2000 -MinObstacleSize=60 -MaxObstacleSize=120 -Seed=1234
+ */
+UCLASS()
+class USObstacleLayoutCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	USObstacleLayoutCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,182 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Learning/SObstacleLayoutLibrary.h"
+#include "Learning/SObstacleGrid.h"
+#include "Learning/SObstacleLayoutSampler.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+
+namespace SObstacleLayoutLibrary
+{
+	// Candidate layouts tried for one slot before generation gives up on the settings
+	static constexpr int32 MaxAttemptsPerLayout = 100;
+
+	// Darts thrown per requested spawn point
+	static constexpr int32 DartsPerSpawnPoint = 30;
+}
+
+FSObstacleLayoutLibrary::FSObstacleLayoutLibrary() = default;
+
+FSObstacleLayoutLibrary::~FSObstacleLayoutLibrary()
+{
+	Close();
+}
+
+int64 FSObstacleLayoutLibrary::GetLayoutStride(const FSObstacleLayoutFileHeader& InHeader)
+{
+	return (int64)InHeader.ObstaclesPerLayout * sizeof(FSObstacleLayoutBox) + (int64)InHeader.SpawnPointsPerLayout * sizeof(FVector2f);
+}
+
+int32 FSObstacleLayoutLibrary::Generate(const FSObstacleLayoutLibrarySettings& Settings, const FString& Filename)
+{
+	using namespace SObstacleLayoutLibrary;
+
+	if (Settings.LayoutNum <= 0 || Settings.ObstaclesPerLayout < 0 || Settings.SpawnPointsPerLayout < 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("SObstacleLayoutLibrary: Invalid settings - %d layouts of %d obstacles and %d spawn points"),
+			Settings.LayoutNum, Settings.ObstaclesPerLayout, Settings.SpawnPointsPerLayout);
+		return INDEX_NONE;
+	}
+
+	FSObstacleLayoutFileHeader FileHeader;
+	FileHeader.LayoutNum = Settings.LayoutNum;
+	FileHeader.ObstaclesPerLayout = Settings.ObstaclesPerLayout;
+	FileHeader.SpawnPointsPerLayout = Settings.SpawnPointsPerLayout;
+	FileHeader.Seed = Settings.Seed;
+	FileHeader.RegionExtent = Settings.RegionExtent;
+	FileHeader.AgentRadius = Settings.AgentRadius;
+
+	const int64 Stride = GetLayoutStride(FileHeader);
+	TArray64<uint8> Data;
+	Data.SetNumZeroed(sizeof(FSObstacleLayoutFileHeader) + Stride * Settings.LayoutNum);
+	FMemory::Memcpy(Data.GetData(), &FileHeader, sizeof(FSObstacleLayoutFileHeader));
+
+	// Same size rules as USObstacleManager, obstacles never exceed 80% of the region
+	const FBox2D Region(FVector2D(-Settings.RegionExtent), FVector2D(Settings.RegionExtent));
+	const float MaxWidthX = FMath::Min(Settings.MaxObstacleSize, Settings.RegionExtent.X * 2.0f * 0.8f);
+	const float MaxWidthY = FMath::Min(Settings.MaxObstacleSize, Settings.RegionExtent.Y * 2.0f * 0.8f);
+
+	FRandomStream Random(Settings.Seed);
+	TArray<FVector2D> Positions;
+	TArray<FBox> Boxes;
+	TArray<FVector2f> SpawnPoints;
+	FSObstacleGrid Grid;
+	int32 Rejected = 0;
+
+	for (int32 LayoutIndex = 0; LayoutIndex < Settings.LayoutNum; LayoutIndex++)
+	{
+		int32 Attempts = 0;
+		for (;;)
+		{
+			FSObstacleLayoutSampler::Sample(Region, Settings.ObstaclesPerLayout, Settings.MinObstacleSize, {}, 0.0f, Random, Positions);
+
+			Boxes.Reset();
+			for (const FVector2D& Position : Positions)
+			{
+				const FVector HalfSize(Random.FRandRange(Settings.MinObstacleSize, MaxWidthX) * 0.5f, Random.FRandRange(Settings.MinObstacleSize, MaxWidthY) * 0.5f, 1.0f);
+				Boxes.Add(FBox(FVector(Position, 0.0) - HalfSize, FVector(Position, 0.0) + HalfSize));
+			}
+			Grid.Build(Boxes);
+
+			// A layout is only kept when it leaves room for every spawn point
+			SpawnPoints.Reset();
+			for (int32 Dart = 0; Dart < DartsPerSpawnPoint * Settings.SpawnPointsPerLayout && SpawnPoints.Num() < Settings.SpawnPointsPerLayout; Dart++)
+			{
+				const FVector2D Candidate(Random.FRandRange(Region.Min.X, Region.Max.X), Random.FRandRange(Region.Min.Y, Region.Max.Y));
+				if (!Grid.IsLocationBlocked(FVector(Candidate, 0.0), Settings.AgentRadius))
+				{
+					SpawnPoints.Add(FVector2f(Candidate));
+				}
+			}
+
+			if (SpawnPoints.Num() == Settings.SpawnPointsPerLayout)
+			{
+				break;
+			}
+
+			Rejected++;
+			if (++Attempts >= MaxAttemptsPerLayout)
+			{
+				UE_LOG(LogTemp, Error, TEXT("SObstacleLayoutLibrary: Could not fit %d spawn points around %d obstacles after %d layouts, use fewer or smaller obstacles"),
+					Settings.SpawnPointsPerLayout, Settings.ObstaclesPerLayout, Attempts);
+				return INDEX_NONE;
+			}
+		}
+
+		uint8* Record = Data.GetData() + sizeof(FSObstacleLayoutFileHeader) + Stride * LayoutIndex;
+		FSObstacleLayoutBox* RecordBoxes = reinterpret_cast<FSObstacleLayoutBox*>(Record);
+		for (int32 BoxIndex = 0; BoxIndex < Boxes.Num(); BoxIndex++)
+		{
+			RecordBoxes[BoxIndex].Center = FVector2f(FVector2D(Boxes[BoxIndex].GetCenter()));
+			RecordBoxes[BoxIndex].HalfSize = FVector2f(FVector2D(Boxes[BoxIndex].GetExtent()));
+		}
+		FMemory::Memcpy(Record + Settings.ObstaclesPerLayout * sizeof(FSObstacleLayoutBox), SpawnPoints.GetData(), SpawnPoints.Num() * sizeof(FVector2f));
+	}
+
+	if (!FFileHelper::SaveArrayToFile(Data, *Filename))
+	{
+		UE_LOG(LogTemp, Error, TEXT("SObstacleLayoutLibrary: Failed to write %s"), *Filename);
+		return INDEX_NONE;
+	}
+
+	return Rejected;
+}
+
+bool FSObstacleLayoutLibrary::Open(const FString& Filename)
+{
+	Close();
+
+	MappedFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Filename));
+	if (!MappedFile)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SObstacleLayoutLibrary: Could not map %s"), *Filename);
+		return false;
+	}
+
+	const int64 FileSize = MappedFile->GetFileSize();
+	if (FileSize >= (int64)sizeof(FSObstacleLayoutFileHeader))
+	{
+		MappedRegion.Reset(MappedFile->MapRegion(0, FileSize));
+	}
+
+	const FSObstacleLayoutFileHeader* MappedHeader = MappedRegion ? reinterpret_cast<const FSObstacleLayoutFileHeader*>(MappedRegion->GetMappedPtr()) : nullptr;
+	if (!MappedHeader ||
+		MappedHeader->Magic != FSObstacleLayoutFileHeader::ExpectedMagic ||
+		MappedHeader->Version != FSObstacleLayoutFileHeader::ExpectedVersion ||
+		MappedHeader->LayoutNum <= 0 || MappedHeader->ObstaclesPerLayout < 0 || MappedHeader->SpawnPointsPerLayout < 0 ||
+		FileSize != (int64)sizeof(FSObstacleLayoutFileHeader) + GetLayoutStride(*MappedHeader) * MappedHeader->LayoutNum)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SObstacleLayoutLibrary: %s is not a version %u layout library"), *Filename, FSObstacleLayoutFileHeader::ExpectedVersion);
+		Close();
+		return false;
+	}
+
+	Header = MappedHeader;
+	Layouts = MappedRegion->GetMappedPtr() + sizeof(FSObstacleLayoutFileHeader);
+	return true;
+}
+
+void FSObstacleLayoutLibrary::Close()
+{
+	Header = nullptr;
+	Layouts = nullptr;
+
+	// The region has to be released before the file it maps
+	MappedRegion.Reset();
+	MappedFile.Reset();
+}
+
+TArrayView<const FSObstacleLayoutBox> FSObstacleLayoutLibrary::GetObstacles(const int32 LayoutIndex) const
+{
+	check(Header && LayoutIndex >= 0 && LayoutIndex < Header->LayoutNum);
+	const uint8* Record = Layouts + GetLayoutStride(*Header) * LayoutIndex;
+	return MakeArrayView(reinterpret_cast<const FSObstacleLayoutBox*>(Record), Header->ObstaclesPerLayout);
+}
+
+TArrayView<const FVector2f> FSObstacleLayoutLibrary::GetSpawnPoints(const int32 LayoutIndex) const
+{
+	check(Header && LayoutIndex >= 0 && LayoutIndex < Header->LayoutNum);
+	const uint8* Record = Layouts + GetLayoutStride(*Header) * LayoutIndex + Header->ObstaclesPerLayout * sizeof(FSObstacleLayoutBox);
+	return MakeArrayView(reinterpret_cast<const FVector2f*>(Record), Header->SpawnPointsPerLayout);
+}
@@ -0,0 +1,133 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Learning/SObstacleLayoutSampler.h"
+
+namespace SObstacleLayoutSampler
+{
+	// Darts thrown per requested position before the spacing is relaxed
+	static constexpr int32 DartsPerPosition = 30;
+
+	// Each relaxation keeps this fraction of the previous spacing
+	static constexpr float SpacingShrink = 0.8f;
+
+	// Below this spacing, or beyond this many grid cells, the remaining positions are placed without spacing
+	static constexpr float MinUsefulSpacing = 1.0f;
+	static constexpr int32 MaxGridCells = 1 << 20;
+
+	static bool IsExcluded(const FVector2D& Position, TArrayView<const FVector2D> ExclusionCenters, const float ExclusionRadiusSquared)
+	{
+		for (const FVector2D& Center : ExclusionCenters)
+		{
+			if (FVector2D::DistSquared(Position, Center) < ExclusionRadiusSquared)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	static FVector2D RandomPoint(const FBox2D& Region, FRandomStream& Random)
+	{
+		return FVector2D(Random.FRandRange(Region.Min.X, Region.Max.X), Random.FRandRange(Region.Min.Y, Region.Max.Y));
+	}
+}
+
+float FSObstacleLayoutSampler::Sample(const FBox2D& Region, const int32 Count, const float MinSpacing,
+	TArrayView<const FVector2D> ExclusionCenters, const float ExclusionRadius,
+	FRandomStream& Random, TArray<FVector2D>& OutPositions)
+{
+	using namespace SObstacleLayoutSampler;
+
+	OutPositions.Reset(Count);
+	if (Count <= 0)
+	{
+		return 0.0f;
+	}
+
+	const FVector2D RegionSize = Region.GetSize();
+	const float ExclusionRadiusSquared = FMath::Square(ExclusionRadius);
+
+	// Random sequential packing covers a bit over half the region with disks of diameter Spacing, start just below that
+	float Spacing = FMath::Max(MinSpacing, 0.7f * FMath::Sqrt(FMath::Max(RegionSize.X * RegionSize.Y, 1.0) / Count));
+
+	TArray<int32> Grid;
+	while (OutPositions.Num() < Count && Spacing >= MinUsefulSpacing)
+	{
+		// A cell diagonal shorter than Spacing fits at most one point, so a 5x5 block covers every possible neighbour
+		const double CellSize = Spacing / UE_SQRT_2;
+		const int32 NumX = FMath::Max(FMath::CeilToInt(RegionSize.X / CellSize), 1);
+		const int32 NumY = FMath::Max(FMath::CeilToInt(RegionSize.Y / CellSize), 1);
+		if ((int64)NumX * NumY > MaxGridCells)
+		{
+			break;
+		}
+
+		auto CellOf = [&](const FVector2D& Position)
+		{
+			return FIntPoint(
+				FMath::Clamp((int32)((Position.X - Region.Min.X) / CellSize), 0, NumX - 1),
+				FMath::Clamp((int32)((Position.Y - Region.Min.Y) / CellSize), 0, NumY - 1));
+		};
+
+		// Points kept from a wider spacing are still far enough apart for this one
+		Grid.Init(INDEX_NONE, NumX * NumY);
+		for (int32 Index = 0; Index < OutPositions.Num(); Index++)
+		{
+			const FIntPoint Cell = CellOf(OutPositions[Index]);
+			Grid[Cell.Y * NumX + Cell.X] = Index;
+		}
+
+		const float SpacingSquared = FMath::Square(Spacing);
+		const int32 DartNum = DartsPerPosition * Count;
+		for (int32 Dart = 0; Dart < DartNum && OutPositions.Num() < Count; Dart++)
+		{
+			const FVector2D Candidate = RandomPoint(Region, Random);
+			if (IsExcluded(Candidate, ExclusionCenters, ExclusionRadiusSquared))
+			{
+				continue;
+			}
+
+			const FIntPoint Cell = CellOf(Candidate);
+			bool bTooClose = false;
+			for (int32 Y = FMath::Max(Cell.Y - 2, 0); Y <= FMath::Min(Cell.Y + 2, NumY - 1) && !bTooClose; Y++)
+			{
+				for (int32 X = FMath::Max(Cell.X - 2, 0); X <= FMath::Min(Cell.X + 2, NumX - 1); X++)
+				{
+					const int32 Neighbour = Grid[Y * NumX + X];
+					if (Neighbour != INDEX_NONE && FVector2D::DistSquared(Candidate, OutPositions[Neighbour]) < SpacingSquared)
+					{
+						bTooClose = true;
+						break;
+					}
+				}
+			}
+
+			if (!bTooClose)
+			{
+				Grid[Cell.Y * NumX + Cell.X] = OutPositions.Add(Candidate);
+			}
+		}
+
+		if (OutPositions.Num() < Count)
+		{
+			Spacing *= SpacingShrink;
+		}
+	}
+
+	if (OutPositions.Num() == Count)
+	{
+		return Spacing;
+	}
+
+	// Region too crowded for any useful spacing, still honour the exclusions where the region leaves room for it
+	while (OutPositions.Num() < Count)
+	{
+		FVector2D Candidate = RandomPoint(Region, Random);
+		for (int32 Dart = 1; Dart < DartsPerPosition && IsExcluded(Candidate, ExclusionCenters, ExclusionRadiusSquared); Dart++)
+		{
+			Candidate = RandomPoint(Region, Random);
+		}
+		OutPositions.Add(Candidate);
+	}
+	return 0.0f;
+}
@@ -1,6 +1,9 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "Learning/SObstacleManager.h"
+#include "Learning/SObstacleFieldActor.h"
+#include "Learning/SObstacleLayoutSampler.h"
+#include "Learning/SObstacleLayoutLibrary.h"
 #include "Engine/World.h"
 #include "Engine/Engine.h"
 #include "GameFramework/Volume.h"
@@ -10,11 +13,16 @@ USObstacleManager::USObstacleManager()
 {
 	PrimaryComponentTick.bCanEverTick = true;
 	PrimaryComponentTick.TickInterval = 1.0f; // Tick every second
+
+	LayoutRandom.Initialize(RandomSeed);
 }
 
 void USObstacleManager::BeginPlay()
 {
 	Super::BeginPlay();
+
+	// Pick up a seed set in the editor after construction
+	LayoutRandom.Initialize(RandomSeed);
 	
 	// Try to find location volume automatically
 	FindAndSetLocationVolume();
@@ -52,19 +60,7 @@ void USObstacleManager::TickComponent(float DeltaTime, ELevelTick TickType, FAct
 
 void USObstacleManager::InitializeObstacles()
 {
-	// Clear existing obstacles
-	ClearObstacles();
-
-	// Generate obstacles
-	for (int32 i = 0; i < MaxObstacles; i++)
-	{
-		FVector ObstaclePosition = GenerateRandomObstaclePosition(FVector::ZeroVector, 0.0f);
-		ASObstacleActor* NewObstacle = CreateObstacleAtPosition(ObstaclePosition);
-		if (NewObstacle)
-		{
-			CurrentObstacles.Add(NewObstacle);
-		}
-	}
+	GenerateObstacleLayout(MaxObstacles, {}, 0.0f);
 
 	// UE_LOG(LogTemp, Log, TEXT("SObstacleManager: Initialized %d obstacles in %s mode"), 
 	//		CurrentObstacles.Num(), 
@@ -73,90 +69,271 @@ void USObstacleManager::InitializeObstacles()
 
 void USObstacleManager::InitializeObstaclesWithSmartPlacement(const FVector& AgentLocation, const FVector& TargetLocation)
 {
-	// Clear existing obstacles
-	ClearObstacles();
+	// Keep obstacles clear of the agent and the target
+	const FVector AvoidLocations[] = { AgentLocation, TargetLocation };
+	InitializeObstaclesAroundLocations(AvoidLocations);
 
-	// Generate obstacles with smart placement
-	for (int32 i = 0; i < MaxObstacles; i++)
+	// UE_LOG(LogTemp, Log, TEXT("SObstacleManager: Initialized %d obstacles with smart placement (avoiding agents/targets)"), CurrentObstacles.Num());
+}
+
+void USObstacleManager::InitializeObstaclesAroundLocations(TArrayView<const FVector> AvoidLocations)
+{
+	TArray<FVector2D, TInlineAllocator<33>> AvoidLocations2D;
+	for (const FVector& AvoidLocation : AvoidLocations)
 	{
-		FVector ObstaclePosition;
-		int32 Attempts = 0;
-		const int32 MaxAttempts = 50;
-		bool ValidPosition = false;
+		AvoidLocations2D.Add(FVector2D(AvoidLocation));
+	}
+	GenerateObstacleLayout(MaxObstacles, AvoidLocations2D, 150.0f);
+}
 
-		// Try to find a valid position that avoids agents and targets
-		do
+void USObstacleManager::RegenerateObstaclesInRegion(const FBox2D& Region, TArrayView<const FVector> AvoidLocations, TArrayView<const FVector> ProtectedLocations)
+{
+	const FSObstaclePlacementRegion& PlacementBounds = GetPlacementRegion();
+	const FBox2D RegionBounds(
+		FVector2D::Max(Region.Min, FVector2D(PlacementBounds.Origin - PlacementBounds.Extent)),
+		FVector2D::Min(Region.Max, FVector2D(PlacementBounds.Origin + PlacementBounds.Extent)));
+	if (RegionBounds.Min.X >= RegionBounds.Max.X || RegionBounds.Min.Y >= RegionBounds.Max.Y)
+	{
+		return;
+	}
+
+	// Obstacles outside the region, or close enough to a protected location to matter to it, stay where they are
+	const float ProtectedRadiusSquared = FMath::Square(MinDistanceFromAgents);
+	KeptObstacleBounds.Reset(PlacedObstacleBounds.Num());
+	int32 RemovedNum = 0;
+	for (const FBox& Bounds : PlacedObstacleBounds)
+	{
+		const FBox2D Bounds2D(FVector2D(Bounds.Min), FVector2D(Bounds.Max));
+		bool bKeep = !RegionBounds.IsInside(Bounds2D.GetCenter());
+		for (int32 Index = 0; Index < ProtectedLocations.Num() && !bKeep; Index++)
 		{
-		if (LocationVolume)
+			bKeep = Bounds2D.ComputeSquaredDistanceToPoint(FVector2D(ProtectedLocations[Index])) < ProtectedRadiusSquared;
+		}
+
+		if (bKeep)
 		{
-			// Use LocationVolume for positioning
-			FVector VolumeOrigin = LocationVolume->GetActorLocation();
-			FVector VolumeExtent;
-			LocationVolume->GetActorBounds(false, VolumeOrigin, VolumeExtent);
-			
-			// UE_LOG(LogTemp, Log, TEXT("SObstacleManager: Volume Origin: %s, Extent: %s"), 
-				// *VolumeOrigin.ToString(), *VolumeExtent.ToString());
-			
-			// Generate random point within volume bounds
-			ObstaclePosition.X = FMath::RandRange(VolumeOrigin.X - VolumeExtent.X, VolumeOrigin.X + VolumeExtent.X);
-			ObstaclePosition.Y = FMath::RandRange(VolumeOrigin.Y - VolumeExtent.Y, VolumeOrigin.Y + VolumeExtent.Y);
-			ObstaclePosition.Z = VolumeOrigin.Z + VolumeExtent.Z; // Start from top of volume
-			
-			// Find ground level
-			ObstaclePosition.Z = FindGroundLevel(ObstaclePosition);
-			
-			// UE_LOG(LogTemp, Log, TEXT("SObstacleManager: Generated obstacle position: %s"), *ObstaclePosition.ToString());
+			KeptObstacleBounds.Add(Bounds);
 		}
 		else
-			{
-				// Fallback to environment bounds
-				ObstaclePosition.X = EnvironmentCenter.X + FMath::RandRange(-EnvironmentBounds.X, EnvironmentBounds.X);
-				ObstaclePosition.Y = EnvironmentCenter.Y + FMath::RandRange(-EnvironmentBounds.Y, EnvironmentBounds.Y);
-				ObstaclePosition.Z = EnvironmentCenter.Z;
-				ObstaclePosition.Z = FindGroundLevel(ObstaclePosition);
-			}
-			
-			// Ensure obstacle is properly above ground
-			ObstaclePosition.Z += 10.0f;
-			
-			// Check if position is valid (avoids agents and targets)
-			ValidPosition = IsValidObstaclePosition(ObstaclePosition, AgentLocation, 150.0f) && 
-							IsValidObstaclePosition(ObstaclePosition, TargetLocation, 150.0f);
-			
-			Attempts++;
-		} while (!ValidPosition && Attempts < MaxAttempts);
-
-		// Create obstacle if we found a valid position
-		if (ValidPosition)
 		{
-			ASObstacleActor* NewObstacle = CreateObstacleAtPosition(ObstaclePosition);
-			if (NewObstacle)
-			{
-				CurrentObstacles.Add(NewObstacle);
-			}
+			RemovedNum++;
 		}
 	}
 
-	// UE_LOG(LogTemp, Log, TEXT("SObstacleManager: Initialized %d obstacles with smart placement (avoiding agents/targets)"), CurrentObstacles.Num());
+	if (RemovedNum == 0)
+	{
+		return;
+	}
+
+	// New obstacles keep clear of the kept ones, the new starts and the protected locations
+	RegionExclusionCenters.Reset(KeptObstacleBounds.Num() + AvoidLocations.Num() + ProtectedLocations.Num());
+	for (const FBox& Bounds : KeptObstacleBounds)
+	{
+		RegionExclusionCenters.Add(FVector2D(Bounds.GetCenter()));
+	}
+	for (const FVector& AvoidLocation : AvoidLocations)
+	{
+		RegionExclusionCenters.Add(FVector2D(AvoidLocation));
+	}
+	for (const FVector& ProtectedLocation : ProtectedLocations)
+	{
+		RegionExclusionCenters.Add(FVector2D(ProtectedLocation));
+	}
+
+	ReleaseObstacles();
+	CurrentLayoutIndex = INDEX_NONE;
+
+	for (const FBox& Bounds : KeptObstacleBounds)
+	{
+		const FVector Size = Bounds.GetSize();
+		PlaceObstacle(Bounds.GetCenter(), Size.X, Size.Y);
+	}
+
+	FSObstacleLayoutSampler::Sample(RegionBounds, RemovedNum, MinObstacleSize, RegionExclusionCenters, MinDistanceFromAgents, LayoutRandom, LayoutPositions);
+
+	for (const FVector2D& LayoutPosition : LayoutPositions)
+	{
+		FVector ObstaclePosition(LayoutPosition, 0.0f);
+		ObstaclePosition.Z = FindGroundLevel(ObstaclePosition) + 10.0f; // Small offset to prevent clipping
+		PlaceObstacleAtPosition(ObstaclePosition);
+	}
+
+	CommitObstacleLayout();
 }
 
-void USObstacleManager::ClearObstacles()
+void USObstacleManager::GenerateObstacleLayout(const int32 ObstacleCount, TArrayView<const FVector2D> AvoidLocations, const float AvoidRadius)
+{
+	// Stored layouts carry no exclusions, so only layouts without any come from the library
+	if (HasLayoutLibrary() && AvoidLocations.Num() == 0)
+	{
+		ApplyLibraryLayout();
+		return;
+	}
+
+	// Return existing obstacles to the pool
+	ReleaseObstacles();
+	CurrentLayoutIndex = INDEX_NONE;
+
+	const FSObstaclePlacementRegion& Region = GetPlacementRegion();
+	const FBox2D RegionBounds(FVector2D(Region.Origin - Region.Extent), FVector2D(Region.Origin + Region.Extent));
+
+	// Obstacle centers are never closer than the smallest obstacle, as with the old per-position rejection sampling
+	FSObstacleLayoutSampler::Sample(RegionBounds, ObstacleCount, MinObstacleSize, AvoidLocations, AvoidRadius, LayoutRandom, LayoutPositions);
+
+	for (const FVector2D& LayoutPosition : LayoutPositions)
+	{
+		FVector ObstaclePosition(LayoutPosition, 0.0f);
+		ObstaclePosition.Z = FindGroundLevel(ObstaclePosition) + 10.0f; // Small offset to prevent clipping
+		PlaceObstacleAtPosition(ObstaclePosition);
+	}
+
+	CommitObstacleLayout();
+}
+
+void USObstacleManager::SetLayoutLibrary(TSharedPtr<const FSObstacleLayoutLibrary> InLayoutLibrary)
 {
-	for (ASObstacleActor* Obstacle : CurrentObstacles)
+	LayoutLibrary = InLayoutLibrary && InLayoutLibrary->IsOpen() ? InLayoutLibrary : nullptr;
+	CurrentLayoutIndex = INDEX_NONE;
+
+	if (LayoutLibrary)
+	{
+		const FVector2f LibraryExtent = LayoutLibrary->GetHeader().RegionExtent;
+		const FVector& RegionExtent = GetPlacementRegion().Extent;
+		UE_CLOG(!FMath::IsNearlyEqual(LibraryExtent.X, RegionExtent.X, 1.0f) || !FMath::IsNearlyEqual(LibraryExtent.Y, RegionExtent.Y, 1.0f),
+			LogTemp, Warning, TEXT("SObstacleManager: Layout library was generated for a %sx%s region but this one is %sx%s"),
+			*FString::SanitizeFloat(LibraryExtent.X * 2.0f), *FString::SanitizeFloat(LibraryExtent.Y * 2.0f),
+			*FString::SanitizeFloat(RegionExtent.X * 2.0f), *FString::SanitizeFloat(RegionExtent.Y * 2.0f));
+	}
+}
+
+bool USObstacleManager::HasLayoutLibrary() const
+{
+	return LayoutLibrary.IsValid();
+}
+
+void USObstacleManager::ApplyLibraryLayout(int32 LayoutIndex)
+{
+	if (!LayoutLibrary)
+	{
+		return;
+	}
+
+	CurrentLayoutIndex = LayoutLibrary->GetLayoutNum() > 0 && (LayoutIndex < 0 || LayoutIndex >= LayoutLibrary->GetLayoutNum())
+		? LayoutRandom.RandHelper(LayoutLibrary->GetLayoutNum())
+		: LayoutIndex;
+
+	ReleaseObstacles();
+
+	const FVector& RegionOrigin = GetPlacementRegion().Origin;
+	for (const FSObstacleLayoutBox& Box : LayoutLibrary->GetObstacles(CurrentLayoutIndex))
+	{
+		FVector ObstaclePosition(RegionOrigin.X + Box.Center.X, RegionOrigin.Y + Box.Center.Y, 0.0f);
+		ObstaclePosition.Z = FindGroundLevel(ObstaclePosition) + 10.0f; // Small offset to prevent clipping
+		PlaceObstacle(ObstaclePosition, Box.HalfSize.X * 2.0f, Box.HalfSize.Y * 2.0f);
+	}
+
+	CommitObstacleLayout();
+}
+
+bool USObstacleManager::FindLibrarySpawnPoint(const FBox2D& AllowedArea, TArrayView<const FVector2D> TakenLocations, FVector2D& OutLocation)
+{
+	if (!LayoutLibrary || CurrentLayoutIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	// Start at a random spawn point and take the first free one inside the allowed area
+	const TArrayView<const FVector2f> SpawnPoints = LayoutLibrary->GetSpawnPoints(CurrentLayoutIndex);
+	const FVector2D RegionOrigin(GetPlacementRegion().Origin);
+	const int32 FirstIndex = SpawnPoints.Num() > 0 ? LayoutRandom.RandHelper(SpawnPoints.Num()) : 0;
+	for (int32 Offset = 0; Offset < SpawnPoints.Num(); Offset++)
 	{
-		if (IsValid(Obstacle))
+		const FVector2D Candidate = RegionOrigin + FVector2D(SpawnPoints[(FirstIndex + Offset) % SpawnPoints.Num()]);
+		if (AllowedArea.IsInsideOrOn(Candidate) && !TakenLocations.Contains(Candidate))
 		{
-			Obstacle->Destroy();
+			OutLocation = Candidate;
+			return true;
 		}
 	}
-	CurrentObstacles.Empty();
+	return false;
+}
+
+void USObstacleManager::SetRandomSeed(int32 NewRandomSeed)
+{
+	RandomSeed = NewRandomSeed;
+	LayoutRandom.Initialize(RandomSeed);
+}
+
+void USObstacleManager::ClearObstacles()
+{
+	ReleaseObstacles();
+	CommitObstacleLayout();
+}
+
+void USObstacleManager::ReleaseObstacles()
+{
+	// Drop anything destroyed behind our back, e.g. on level teardown
+	ObstaclePool.RemoveAll([](const ASObstacleActor* Obstacle) { return !IsValid(Obstacle); });
+	CurrentObstacles.Reset();
+	PlacedObstacleBounds.Reset();
+	NextPooledObstacle = 0;
+}
+
+void USObstacleManager::CommitObstacleLayout()
+{
+	HideUnusedObstacles();
+
+	if (bUseInstancedObstacles && !ObstacleField && GetWorld())
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		ObstacleField = GetWorld()->SpawnActor<ASObstacleFieldActor>(ASObstacleFieldActor::StaticClass(), FTransform::Identity, SpawnParams);
+	}
+
+	// The field is emptied rather than destroyed when switching back to actors, so it can be reused later
+	if (ObstacleField)
+	{
+		ObstacleField->SetObstacles(bUseInstancedObstacles ? TArrayView<const FBox>(PlacedObstacleBounds) : TArrayView<const FBox>());
+	}
+
+	ObstacleIndex.Build(PlacedObstacleBounds);
+}
+
+void USObstacleManager::HideUnusedObstacles()
+{
+	for (int32 PoolIndex = NextPooledObstacle; PoolIndex < ObstaclePool.Num(); PoolIndex++)
+	{
+		ObstaclePool[PoolIndex]->SetObstacleActive(false);
+	}
+}
+
+ASObstacleActor* USObstacleManager::AcquirePooledObstacle(const FVector& Position)
+{
+	if (NextPooledObstacle < ObstaclePool.Num())
+	{
+		ASObstacleActor* Obstacle = ObstaclePool[NextPooledObstacle++];
+		Obstacle->SetActorLocation(Position, false, nullptr, ETeleportType::TeleportPhysics);
+		Obstacle->SetObstacleActive(true);
+		return Obstacle;
+	}
+
+	// Pool exhausted, grow it by one
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	ASObstacleActor* NewObstacle = GetWorld()->SpawnActor<ASObstacleActor>(ObstacleClass, Position, FRotator::ZeroRotator, SpawnParams);
+	if (NewObstacle)
+	{
+		ObstaclePool.Add(NewObstacle);
+		NextPooledObstacle = ObstaclePool.Num();
+	}
+	return NewObstacle;
 }
 
 void USObstacleManager::RegenerateObstacles()
 {
 	if (ObstacleMode == EObstacleMode::Dynamic)
 	{
-		ClearObstacles();
 		InitializeObstacles();
 		// UE_LOG(LogTemp, Log, TEXT("SObstacleManager: Regenerated obstacles in dynamic mode"));
 	}
@@ -168,14 +345,35 @@ void USObstacleManager::RegenerateObstacles()
 
 bool USObstacleManager::IsLocationBlocked(const FVector& Location, float AgentRadius) const
 {
-	for (ASObstacleActor* Obstacle : CurrentObstacles)
+	return ObstacleIndex.IsLocationBlocked(Location, AgentRadius);
+}
+
+void USObstacleManager::AreLocationsBlocked(TArrayView<const FVector> Locations, float AgentRadius, TArrayView<bool> OutBlocked) const
+{
+	ObstacleIndex.AreLocationsBlocked(Locations, AgentRadius, OutBlocked);
+}
+
+void USObstacleManager::TraceObstacleRays(const FVector& Origin, TArrayView<const FVector2f> Directions, float MaxDistance, TArrayView<float> OutDistances) const
+{
+	ObstacleIndex.TraceRays(Origin, Directions, MaxDistance, OutDistances);
+}
+
+void USObstacleManager::RebuildObstacleIndex()
+{
+	// Obstacle actors may have been moved or resized from outside, the instanced field is only ever changed by us
+	if (!bUseInstancedObstacles)
 	{
-		if (IsValid(Obstacle) && Obstacle->IsLocationBlocked(Location, AgentRadius))
+		PlacedObstacleBounds.Reset();
+		for (const ASObstacleActor* Obstacle : CurrentObstacles)
 		{
-			return true;
+			if (IsValid(Obstacle))
+			{
+				PlacedObstacleBounds.Add(Obstacle->GetObstacleBounds());
+			}
 		}
 	}
-	return false;
+
+	ObstacleIndex.Build(PlacedObstacleBounds);
 }
 
 void USObstacleManager::SetObstacleMode(EObstacleMode NewMode)
@@ -194,168 +392,152 @@ void USObstacleManager::SetObstacleMode(EObstacleMode NewMode)
 	}
 }
 
-FVector USObstacleManager::GenerateRandomObstaclePosition(const FVector& AvoidLocation, float AvoidRadius) const
+bool USObstacleManager::PlaceObstacleAtPosition(const FVector& Position)
 {
-	FVector Position;
-	int32 Attempts = 0;
-	const int32 MaxAttempts = 100;
+	// Obstacle dimensions based on the placement region
+	const FSObstaclePlacementRegion& Region = GetPlacementRegion();
+	const float VolumeWidthX = Region.Extent.X * 2.0f;
+	const float VolumeWidthY = Region.Extent.Y * 2.0f;
+	
+	// Create obstacles that are randomly wide
+	float WidthX = LayoutRandom.FRandRange(MinObstacleSize, FMath::Min(MaxObstacleSize, VolumeWidthX * 0.8f));
+	float WidthY = LayoutRandom.FRandRange(MinObstacleSize, FMath::Min(MaxObstacleSize, VolumeWidthY * 0.8f));
+	
+	return PlaceObstacle(Position, WidthX, WidthY);
+}
 
-	do
+bool USObstacleManager::PlaceObstacle(const FVector& Position, const float WidthX, const float WidthY)
+{
+	// Instanced obstacles are only bounds until the layout is committed, so they need no world to be placed
+	if (!bUseInstancedObstacles && (!GetWorld() || !ObstacleClass))
 	{
-		if (LocationVolume)
-		{
-			// Use LocationVolume for positioning
-			FVector VolumeOrigin = LocationVolume->GetActorLocation();
-			FVector VolumeExtent;
-			LocationVolume->GetActorBounds(false, VolumeOrigin, VolumeExtent);
-			
-			// Generate random point within volume bounds
-			Position.X = FMath::RandRange(VolumeOrigin.X - VolumeExtent.X, VolumeOrigin.X + VolumeExtent.X);
-			Position.Y = FMath::RandRange(VolumeOrigin.Y - VolumeExtent.Y, VolumeOrigin.Y + VolumeExtent.Y);
-			Position.Z = VolumeOrigin.Z + VolumeExtent.Z; // Start from top of volume
-			
-			// Find ground level
-			Position.Z = FindGroundLevel(Position);
-		}
-		else
+		// UE_LOG(LogTemp, Warning, TEXT("SObstacleManager: Cannot create obstacle - World: %s, ObstacleClass: %s"), 
+			// GetWorld() ? TEXT("Valid") : TEXT("NULL"), ObstacleClass ? TEXT("Valid") : TEXT("NULL"));
+		return false;
+	}
+
+	// UE_LOG(LogTemp, Log, TEXT("SObstacleManager: Creating obstacle at position: %s"), *Position.ToString());
+
+	const float Height = GetObstacleHeight();
+	
+	if (!bUseInstancedObstacles)
+	{
+		// Reuse a pooled obstacle, only spawns when every pooled one is already placed
+		ASObstacleActor* NewObstacle = AcquirePooledObstacle(Position);
+		if (!NewObstacle)
 		{
-			// Fallback to environment bounds
-			Position.X = EnvironmentCenter.X + FMath::RandRange(-EnvironmentBounds.X, EnvironmentBounds.X);
-			Position.Y = EnvironmentCenter.Y + FMath::RandRange(-EnvironmentBounds.Y, EnvironmentBounds.Y);
-			Position.Z = EnvironmentCenter.Z;
-			Position.Z = FindGroundLevel(Position);
+			return false;
 		}
-		
-		// Ensure obstacle is properly above ground
-		Position.Z += 10.0f; // Small offset to prevent clipping
-		
-		Attempts++;
-	} while (!IsValidObstaclePosition(Position, AvoidLocation, AvoidRadius) && Attempts < MaxAttempts);
+		NewObstacle->InitializeObstacle(WidthX, Height, WidthY);
+		CurrentObstacles.Add(NewObstacle);
+	}
+
+	// Same extents as ASObstacleActor::GetObstacleBounds for an actor initialized with these dimensions
+	PlacedObstacleBounds.Add(FBox(Position - FVector(WidthX, WidthY, Height) * 0.5f, Position + FVector(WidthX, WidthY, Height) * 0.5f));
+	
+	// UE_LOG(LogTemp, Log, TEXT("SObstacleManager: Created obstacle at %s with WX:%f WY:%f H:%f"), 
+		// *Position.ToString(), WidthX, WidthY, Height);
 
-	return Position;
+	return true;
 }
 
-bool USObstacleManager::IsValidObstaclePosition(const FVector& Position, const FVector& AvoidLocation, float AvoidRadius) const
+float USObstacleManager::GetObstacleHeight() const
 {
-	// Check if position is within bounds
-	if (LocationVolume)
+	// Obstacles span the full height of the placement region unless given their own
+	return ObstacleHeight > 0.0f ? ObstacleHeight : GetPlacementRegion().Extent.Z * 2.0f;
+}
+
+const FSObstaclePlacementRegion& USObstacleManager::GetPlacementRegion() const
+{
+	if (!bPlacementRegionValid)
 	{
-		// Check if position is within volume bounds
-		FVector VolumeOrigin = LocationVolume->GetActorLocation();
-		FVector VolumeExtent;
-		LocationVolume->GetActorBounds(false, VolumeOrigin, VolumeExtent);
-		
-		if (Position.X < VolumeOrigin.X - VolumeExtent.X || Position.X > VolumeOrigin.X + VolumeExtent.X ||
-			Position.Y < VolumeOrigin.Y - VolumeExtent.Y || Position.Y > VolumeOrigin.Y + VolumeExtent.Y)
+		if (LocationVolume)
 		{
-			return false;
+			// Use LocationVolume for positioning
+			LocationVolume->GetActorBounds(false, PlacementRegion.Origin, PlacementRegion.Extent);
 		}
-	}
-	else
-	{
-		// Fallback to environment bounds
-		if (Position.X < EnvironmentCenter.X - EnvironmentBounds.X || Position.X > EnvironmentCenter.X + EnvironmentBounds.X ||
-			Position.Y < EnvironmentCenter.Y - EnvironmentBounds.Y || Position.Y > EnvironmentCenter.Y + EnvironmentBounds.Y)
+		else
 		{
-			return false;
+			// Fallback to environment bounds
+			PlacementRegion.Origin = EnvironmentCenter;
+			PlacementRegion.Extent = EnvironmentBounds;
 		}
-	}
 
-	// Check distance from avoid location (agents/targets)
-	if (AvoidRadius > 0.0f && FVector::Dist(Position, AvoidLocation) < AvoidRadius)
-	{
-		return false;
-	}
+		// Ground is searched for around the environment center whichever region is used
+		PlacementRegion.GroundTraceStartZ = EnvironmentCenter.Z + 1000.0f;
+		PlacementRegion.GroundTraceEndZ = EnvironmentCenter.Z - 1000.0f;
+		PlacementRegion.DefaultGroundZ = EnvironmentCenter.Z;
 
-	// Check distance from existing obstacles
-	for (ASObstacleActor* Obstacle : CurrentObstacles)
-	{
-		if (IsValid(Obstacle))
+		PlacementRegion.GroundHeights.Reset();
+		if (bCacheGroundHeights && GetWorld())
 		{
-			float Distance = FVector::Dist(Position, Obstacle->GetActorLocation());
-			if (Distance < MinObstacleSize) // Minimum distance between obstacles
-			{
-				return false;
-			}
+			SampleGroundHeights(PlacementRegion);
 		}
+		bPlacementRegionValid = true;
 	}
-
-	return true;
+	return PlacementRegion;
 }
 
-ASObstacleActor* USObstacleManager::CreateObstacleAtPosition(const FVector& Position)
+void USObstacleManager::SampleGroundHeights(FSObstaclePlacementRegion& Region) const
 {
-	if (!GetWorld() || !ObstacleClass)
+	// Samples sit on the region's corners and every cell edge in between, capped so huge regions stay cheap
+	const int32 MaxSamplesPerAxis = 256;
+	const float CellSize = FMath::Max3(GroundCacheCellSize, Region.Extent.X * 2.0f / (MaxSamplesPerAxis - 1), Region.Extent.Y * 2.0f / (MaxSamplesPerAxis - 1));
+	Region.GroundCellSize = FMath::Max(CellSize, 1.0f);
+	Region.GroundNumX = FMath::CeilToInt(Region.Extent.X * 2.0f / Region.GroundCellSize) + 1;
+	Region.GroundNumY = FMath::CeilToInt(Region.Extent.Y * 2.0f / Region.GroundCellSize) + 1;
+	Region.GroundHeights.SetNumUninitialized(Region.GroundNumX * Region.GroundNumY);
+
+	const FVector RegionMin = Region.Origin - Region.Extent;
+	for (int32 Y = 0; Y < Region.GroundNumY; Y++)
 	{
-		// UE_LOG(LogTemp, Warning, TEXT("SObstacleManager: Cannot create obstacle - World: %s, ObstacleClass: %s"), 
-			// GetWorld() ? TEXT("Valid") : TEXT("NULL"), ObstacleClass ? TEXT("Valid") : TEXT("NULL"));
-		return nullptr;
+		for (int32 X = 0; X < Region.GroundNumX; X++)
+		{
+			const FVector SamplePosition(RegionMin.X + X * Region.GroundCellSize, RegionMin.Y + Y * Region.GroundCellSize, 0.0f);
+			Region.GroundHeights[Y * Region.GroundNumX + X] = TraceGroundLevel(SamplePosition, Region);
+		}
 	}
 
-	// UE_LOG(LogTemp, Log, TEXT("SObstacleManager: Creating obstacle at position: %s"), *Position.ToString());
+	UE_LOG(LogTemp, Log, TEXT("SObstacleManager: Cached %dx%d ground heights at %.0f unit spacing"), Region.GroundNumX, Region.GroundNumY, Region.GroundCellSize);
+}
 
-	// Spawn obstacle
-	FActorSpawnParameters SpawnParams;
-	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
-	
-	ASObstacleActor* NewObstacle = GetWorld()->SpawnActor<ASObstacleActor>(ObstacleClass, Position, FRotator::ZeroRotator, SpawnParams);
-	
-	if (NewObstacle)
+void USObstacleManager::RefreshGroundHeightCache()
+{
+	bPlacementRegionValid = false;
+	GetPlacementRegion();
+}
+
+float USObstacleManager::FindGroundLevel(const FVector& Position) const
+{
+	const FSObstaclePlacementRegion& Region = GetPlacementRegion();
+	if (Region.HasGroundHeights() && Region.ContainsXY(Position))
 	{
-		// Calculate obstacle dimensions based on volume
-		float VolumeHeight = 1000.0f; // Default height if no volume
-		float VolumeWidthX = 200.0f;  // Default width if no volume
-		float VolumeWidthY = 200.0f;  // Default width if no volume
-		
-		// Get dimensions from location volume if available
-		if (LocationVolume)
-		{
-			FVector VolumeOrigin = LocationVolume->GetActorLocation();
-			FVector VolumeExtent;
-			LocationVolume->GetActorBounds(false, VolumeOrigin, VolumeExtent);
-			VolumeHeight = VolumeExtent.Z * 2.0f; // Full height of volume
-			VolumeWidthX = VolumeExtent.X * 2.0f;  // Full width of volume
-			VolumeWidthY = VolumeExtent.Y * 2.0f;  // Full width of volume
-		}
-		else
-		{
-			// Use environment bounds as fallback
-			VolumeHeight = EnvironmentBounds.Z * 2.0f;
-			VolumeWidthX = EnvironmentBounds.X * 2.0f;
-			VolumeWidthY = EnvironmentBounds.Y * 2.0f;
-		}
-		
-		// Create obstacles that span the full height and are randomly wide
-		float WidthX = FMath::RandRange(MinObstacleSize, FMath::Min(MaxObstacleSize, VolumeWidthX * 0.8f));
-		float WidthY = FMath::RandRange(MinObstacleSize, FMath::Min(MaxObstacleSize, VolumeWidthY * 0.8f));
-		float Height = VolumeHeight; // Use full volume height
-		float Depth = FMath::RandRange(WidthX * 0.1f, WidthX * 0.3f); // Thin walls
-		
-		NewObstacle->InitializeObstacle(WidthX, Height, WidthY);
-		
-		// UE_LOG(LogTemp, Log, TEXT("SObstacleManager: Created obstacle at %s with WX:%f WY:%f H:%f D:%f (Volume: %fx%fx%f)"), 
-			// *Position.ToString(), WidthX, WidthY, Height, Depth, VolumeWidthX, VolumeWidthY, VolumeHeight);
+		return Region.GetGroundZ(Position);
 	}
 
-	return NewObstacle;
+	return TraceGroundLevel(Position, Region);
 }
 
-float USObstacleManager::FindGroundLevel(const FVector& Position) const
+float USObstacleManager::TraceGroundLevel(const FVector& Position, const FSObstaclePlacementRegion& Region) const
 {
 	if (!GetWorld())
 	{
-		return EnvironmentCenter.Z;
+		return Region.DefaultGroundZ;
 	}
 
 	// Line trace from above to find ground
-	FVector TraceStart = FVector(Position.X, Position.Y, EnvironmentCenter.Z + 1000.0f);
-	FVector TraceEnd = FVector(Position.X, Position.Y, EnvironmentCenter.Z - 1000.0f);
+	FVector TraceStart = FVector(Position.X, Position.Y, Region.GroundTraceStartZ);
+	FVector TraceEnd = FVector(Position.X, Position.Y, Region.GroundTraceEndZ);
 	
 	FHitResult HitResult;
 	FCollisionQueryParams QueryParams;
 	QueryParams.bTraceComplex = false;
+
+	// Our own obstacles are not ground, whether or not they are currently placed
+	QueryParams.AddIgnoredActors(ObstaclePool);
+	QueryParams.AddIgnoredActor(ObstacleField);
 	
-	float GroundZ = EnvironmentCenter.Z; // Default to environment center if no ground found
+	float GroundZ = Region.DefaultGroundZ; // Default to environment center if no ground found
 	if (GetWorld()->LineTraceSingleByChannel(HitResult, TraceStart, TraceEnd, ECC_WorldStatic, QueryParams))
 	{
 		GroundZ = HitResult.Location.Z;
@@ -367,6 +549,7 @@ float USObstacleManager::FindGroundLevel(const FVector& Position) const
 void USObstacleManager::SetLocationVolume(AVolume* NewLocationVolume)
 {
 	LocationVolume = NewLocationVolume;
+	bPlacementRegionValid = false;
 	// UE_LOG(LogTemp, Log, TEXT("SObstacleManager: LocationVolume set to %s"), 
 		// LocationVolume ? *LocationVolume->GetName() : TEXT("NULL"));
 }
@@ -412,21 +595,10 @@ void USObstacleManager::ShuffleObstaclePositions()
 	// UE_LOG(LogTemp, Log, TEXT("SObstacleManager: Shuffling %d obstacle positions"), CurrentObstacles.Num());
 
 	// Store current obstacle count
-	int32 ObstacleCount = CurrentObstacles.Num();
+	int32 ObstacleCount = GetObstacleNum();
 	
-	// Clear existing obstacles
-	ClearObstacles();
-	
-	// Recreate obstacles with new random positions
-	for (int32 i = 0; i < ObstacleCount; i++)
-	{
-		FVector ObstaclePosition = GenerateRandomObstaclePosition(FVector::ZeroVector, 0.0f);
-		ASObstacleActor* NewObstacle = CreateObstacleAtPosition(ObstaclePosition);
-		if (NewObstacle)
-		{
-			CurrentObstacles.Add(NewObstacle);
-		}
-	}
+	// Reposition pooled obstacles at new random positions
+	GenerateObstacleLayout(ObstacleCount, {}, 0.0f);
 
 	// UE_LOG(LogTemp, Log, TEXT("SObstacleManager: Shuffled %d obstacles to new positions"), CurrentObstacles.Num());
 }
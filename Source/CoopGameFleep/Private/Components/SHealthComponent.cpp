@@ -2,6 +2,7 @@
 
 
 #include "Components/SHealthComponent.h"
+#include "Learning/SCharacterTrainingStats.h"
 
 // Sets default values for this component's properties
 USHealthComponent::USHealthComponent()
@@ -44,7 +45,10 @@ void USHealthComponent::HandleTakeAnyDamange(AActor* DamagedActor, float Damage,
 void USHealthComponent::ResetHealth()
 {
 	Health = DefaultHealth;
-	UE_LOG(LogTemp, Log, TEXT("Health reset to: %s"), *FString::SanitizeFloat(Health));
+
+	// Every episode reset lands here, so only count it unless verbose training logging is on
+	FSCharacterTrainingStats::Get().RecordHealthReset();
+	UE_CLOG(FSCharacterTrainingStats::IsVerbose(), LogTemp, Log, TEXT("Health reset to: %s"), *FString::SanitizeFloat(Health));
 }
 
 
@@ -7,6 +7,7 @@
 #include "GameFramework/PawnMovementComponent.h"
 #include "SWeapon.h"
 #include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
 #include <CoopGameFleep/CoopGameFleep.h>
 #include "Components/SHealthComponent.h"
 
@@ -38,10 +39,20 @@ void ASCharacter::BeginPlay()
 {
 	Super::BeginPlay();
 
-	DefaultFOV = CameraComp->FieldOfView;
+	DefaultFOV = CameraComp ? CameraComp->FieldOfView : 90.0f;
 	ZoomedFOV = 65.f;
 	ZoomInterpSpeed = 20;
 
+	RifleAmmo = 30;
+
+	HealthComp->OnHealthChanged.AddDynamic(this, &ASCharacter::OnHealthChanged);
+
+	if (bTrainingMode)
+	{
+		EnableTrainingMode();
+		return;
+	}
+
 	// Spawn a default weapon
 	FActorSpawnParameters SpawnParams;
 	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
@@ -52,13 +63,41 @@ void ASCharacter::BeginPlay()
 		CurrentWeapon->SetOwner(this);
 		CurrentWeapon->AttachToComponent(GetMesh(), FAttachmentTransformRules::SnapToTargetNotIncludingScale, WeaponAttachSocketName);
 	}
+}
 
+void ASCharacter::EnableTrainingMode()
+{
+	bTrainingMode = true;
 
-	RifleAmmo = 30;
+	// The weapon is a separate actor with its own skeletal mesh, agents never fire it
+	if (CurrentWeapon)
+	{
+		CurrentWeapon->Destroy();
+		CurrentWeapon = nullptr;
+	}
 
+	// Tick only blends the zoom FOV, movement runs from the movement component's own tick
+	SetActorTickEnabled(false);
 
-	HealthComp->OnHealthChanged.AddDynamic(this, &ASCharacter::OnHealthChanged);
+	// Nobody views through an agent
+	if (CameraComp)
+	{
+		CameraComp->DestroyComponent();
+		CameraComp = nullptr;
+	}
+
+	if (SpringArmComp)
+	{
+		SpringArmComp->DestroyComponent();
+		SpringArmComp = nullptr;
+	}
 
+	// Keep the mesh for debugging in the editor, but stop animating it
+	if (USkeletalMeshComponent* MeshComp = GetMesh())
+	{
+		MeshComp->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered;
+		MeshComp->SetComponentTickEnabled(false);
+	}
 }
 
 void ASCharacter::MoveForward(float Value)
@@ -134,6 +173,11 @@ void ASCharacter::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
+	if (!CameraComp)
+	{
+		return;
+	}
+
 	float TargetFOV = bWantsToZoom ? ZoomedFOV : DefaultFOV;
 
 	float NewFOV = FMath::FInterpTo(CameraComp->FieldOfView, TargetFOV, DeltaTime, ZoomInterpSpeed);
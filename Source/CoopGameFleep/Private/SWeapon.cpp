@@ -12,6 +12,7 @@
 #include "TimerManager.h"
 #include <CoopGameFleep/CoopGameFleep.h>
 #include <SCharacter.h>
+#include "Learning/SCharacterTrainingStats.h"
 
 
 static int32 DebugWeaponDrawing = 0;
@@ -114,7 +115,8 @@ void ASWeapon::Fire()
 		LastFireTime = GetWorld()->TimeSeconds;
 		WeaponOwnerCharacter->UpdatePlayerRifleAmmoCount(-1);
 
-		UE_LOG(LogTemp, Log, TEXT("Ammo changed: %s"), *FString::FromInt(WeaponOwnerCharacter->CurrentPlayerRifleAmmoCount()));
+		FSCharacterTrainingStats::Get().RecordAmmoChange();
+		UE_CLOG(FSCharacterTrainingStats::IsVerbose(), LogTemp, Log, TEXT("Ammo changed: %s"), *FString::FromInt(WeaponOwnerCharacter->CurrentPlayerRifleAmmoCount()));
 	}
 }
 
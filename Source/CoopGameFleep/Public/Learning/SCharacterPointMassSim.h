@@ -0,0 +1,162 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/RandomStream.h"
+
+/**
+ * Reward terms of the target-reaching task, shared by the training environment and the point-mass simulator
+ */
+struct FSCharacterTaskRewards
+{
+	float ReachTargetReward = 100.0f;
+	float DistanceRewardScale = 0.1f;
+	float MovementTowardsTargetReward = 0.5f;
+	float FacingTargetReward = 0.2f;
+	float TimeStepPenalty = -0.01f;
+	float BlockedPenalty = -10.0f;
+
+	// Reward for one step. PreviousDistance is negative when unknown, FacingDot is forward . direction-to-target
+	FORCEINLINE float ComputeStepReward(const bool bReached, const bool bBlocked, const float Distance,
+		const float PreviousDistance, const float InvMaxDistance, const float FacingDot) const
+	{
+		float Reward = 0.0f;
+
+		if (bReached)
+		{
+			Reward += ReachTargetReward;
+		}
+		else if (bBlocked)
+		{
+			Reward += BlockedPenalty;
+		}
+		else
+		{
+			// Distance-based reward (closer = better)
+			const float NormalizedDistance = FMath::Clamp(Distance * InvMaxDistance, 0.0f, 1.0f);
+			Reward += (1.0f - NormalizedDistance) * DistanceRewardScale;
+
+			// Movement towards target reward
+			if (PreviousDistance >= 0.0f && Distance < PreviousDistance)
+			{
+				Reward += MovementTowardsTargetReward;
+			}
+
+			// Facing alignment converted from -1..1 to 0..1
+			Reward += (FacingDot + 1.0f) * 0.5f * FacingTargetReward;
+		}
+
+		// Time step penalty to encourage efficiency
+		return Reward + TimeStepPenalty;
+	}
+};
+
+/**
+ * Settings of the point-mass simulator. Movement defaults mirror UCharacterMovementComponent walking,
+ * task defaults mirror USCharacterTrainingEnvironment and ASTargetActor
+ */
+struct FSCharacterPointMassSimSettings
+{
+	// Movement
+	float MaxSpeed = 600.0f;
+	float MaxAcceleration = 2048.0f;
+	float BrakingDeceleration = 2048.0f;
+	float GroundFriction = 8.0f;
+	float BrakingFrictionFactor = 2.0f;
+	float CapsuleRadius = 34.0f;
+
+	// Yaw change for a full turn action, TurnValue * 2 scaled by the default 2.5 controller yaw input scale
+	float TurnDegreesPerStep = 5.0f;
+
+	// Arena, agents and targets share the reset height so only X/Y matter
+	FVector ArenaCenter = FVector::ZeroVector;
+	FVector ArenaBounds = FVector(2000.0f, 2000.0f, 0.0f);
+	float ReachDistance = 150.0f;
+	float MinDistanceBetweenCharacterAndTarget = 500.0f;
+	int32 MaxEpisodeSteps = 1000;
+	FSCharacterTaskRewards Rewards;
+
+	// Obstacles, axis-aligned boxes spanning the full height like ASObstacleActor
+	int32 MaxObstacles = 0;
+	float MinObstacleSize = 60.0f;
+	float MaxObstacleSize = 120.0f;
+	float BlockedCheckRadius = 50.0f;
+	bool bRegenerateObstaclesOnReset = false;
+};
+
+/**
+ * Engine-free re-implementation of the target-reaching task: point-mass agents moving in 2D towards a target
+ * among axis-aligned boxes. Every agent has its own arena copy, target and obstacles. State is kept as
+ * structure-of-arrays indexed by AgentId so a step is a tight loop with no UObjects, physics or allocations.
+ */
+class COOPGAMEFLEEP_API FSCharacterPointMassSim
+{
+public:
+	// Allocate state for AgentNum agents and place every agent with a fresh episode
+	void Initialize(const FSCharacterPointMassSimSettings& InSettings, const int32 InAgentNum, const int32 Seed);
+
+	int32 GetAgentNum() const { return AgentNum; }
+
+	const FSCharacterPointMassSimSettings& GetSettings() const { return Settings; }
+
+	// Start a new episode: new agent and target positions, and new obstacles when regenerating on reset
+	void ResetAgent(const int32 AgentId);
+
+	// Latch the action applied by the following Step, values are clamped to -1..1
+	void SetAction(const int32 AgentId, const float MoveForward, const float MoveRight, const float Turn);
+
+	// Advance every agent by DeltaTime
+	void Step(const float DeltaTime);
+
+	// Rewards and completions for every agent using the sim's own episode state, for running without the engine
+	void Evaluate(TArrayView<float> OutRewards, TArrayView<bool> OutCompleted);
+
+	FVector GetLocation(const int32 AgentId) const { return FVector(PositionX[AgentId], PositionY[AgentId], Height); }
+	FVector GetVelocity(const int32 AgentId) const { return FVector(VelocityX[AgentId], VelocityY[AgentId], 0.0f); }
+	FVector GetForward(const int32 AgentId) const;
+	FVector GetTargetLocation(const int32 AgentId) const { return FVector(TargetX[AgentId], TargetY[AgentId], Height); }
+
+	// Whether the agent is within BlockedCheckRadius of one of its obstacles
+	bool IsAgentBlocked(const int32 AgentId) const { return IsBlocked(AgentId, PositionX[AgentId], PositionY[AgentId], Settings.BlockedCheckRadius); }
+
+	// Whether a point is within Radius of one of the agent's obstacles
+	bool IsLocationBlocked(const int32 AgentId, const FVector2f& Location, const float Radius) const { return IsBlocked(AgentId, Location.X, Location.Y, Radius); }
+
+	bool IsOutOfBounds(const int32 AgentId) const;
+
+	// Distance from the agent to its nearest obstacle along each XY direction, MaxDistance when nothing is that close
+	void TraceObstacleRays(const int32 AgentId, TArrayView<const FVector2f> Directions, const float MaxDistance, TArrayView<float> OutDistances) const;
+
+	// Place one of the agent's obstacles, for tests and fixed layouts
+	void SetObstacle(const int32 AgentId, const int32 ObstacleIndex, const FBox2f& Box);
+
+	void SetAgentState(const int32 AgentId, const FVector2f& Position, const float YawDegrees, const FVector2f& Target);
+
+private:
+	bool IsBlocked(const int32 AgentId, const float X, const float Y, const float Radius) const;
+	FVector2f SamplePoint();
+	void GenerateObstacles(const int32 AgentId, const bool bAvoidAgentAndTarget);
+
+	FSCharacterPointMassSimSettings Settings;
+	FRandomStream Random;
+	int32 AgentNum = 0;
+	float Height = 0.0f;
+
+	// Per-agent state
+	TArray<float> PositionX;
+	TArray<float> PositionY;
+	TArray<float> VelocityX;
+	TArray<float> VelocityY;
+	TArray<float> Yaw;
+	TArray<float> TargetX;
+	TArray<float> TargetY;
+	TArray<float> ActionForward;
+	TArray<float> ActionRight;
+	TArray<float> ActionTurn;
+	TArray<float> PreviousDistances;
+	TArray<int32> EpisodeSteps;
+
+	// MaxObstacles boxes per agent, unused slots are empty
+	TArray<FBox2f> Obstacles;
+};
@@ -0,0 +1,135 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+DECLARE_STATS_GROUP(TEXT("CoopTraining"), STATGROUP_CoopTraining, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Training Step"), STAT_CoopTrainingStep, STATGROUP_CoopTraining, COOPGAMEFLEEP_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Gather Observations"), STAT_CoopGatherObservations, STATGROUP_CoopTraining, COOPGAMEFLEEP_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Perform Actions"), STAT_CoopPerformActions, STATGROUP_CoopTraining, COOPGAMEFLEEP_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Gather Rewards"), STAT_CoopGatherRewards, STATGROUP_CoopTraining, COOPGAMEFLEEP_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Gather Completions"), STAT_CoopGatherCompletions, STATGROUP_CoopTraining, COOPGAMEFLEEP_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Reset Episodes"), STAT_CoopResetEpisodes, STATGROUP_CoopTraining, COOPGAMEFLEEP_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Obstacle Regeneration"), STAT_CoopObstacleRegeneration, STATGROUP_CoopTraining, COOPGAMEFLEEP_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Simulation Step"), STAT_CoopSimStep, STATGROUP_CoopTraining, COOPGAMEFLEEP_API);
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(COOPGAMEFLEEP_API, CoopTraining);
+
+// Stages of a training step, each timed for stat/CSV/Insights and for the per-iteration summary
+enum class ESCharacterTrainingStage : uint8
+{
+	Frame,
+	TrainingStep,
+	GatherObservations,
+	PerformActions,
+	GatherRewards,
+	GatherCompletions,
+	ResetEpisodes,
+	ObstacleRegeneration,
+	SimStep,
+	Num
+};
+
+// Times one stage into the stat group, the CSV profiler, an Insights scope and the iteration summary
+#define SCOPE_COOP_TRAINING_STAGE(Stage) \
+	SCOPE_CYCLE_COUNTER(STAT_Coop##Stage); \
+	CSV_SCOPED_TIMING_STAT(CoopTraining, Stage); \
+	TRACE_CPUPROFILER_EVENT_SCOPE(CoopTraining_##Stage); \
+	FSCharacterTrainingStageTimer ANONYMOUS_VARIABLE(CoopStageTimer)(ESCharacterTrainingStage::Stage)
+
+enum class ESCharacterEpisodeEnd : uint8
+{
+	ReachedTarget,
+	MaxSteps,
+	OutOfBounds,
+	Died,
+	Invalid,
+	Num
+};
+
+/**
+ * In-memory counters for training events that used to be logged one line at a time.
+ * Aggregated on the game thread and emitted as a single summary line per training iteration,
+ * per-event lines are only logged when COOP.LogTrainingEvents is enabled.
+ */
+struct COOPGAMEFLEEP_API FSCharacterTrainingStats
+{
+	static constexpr int32 EpisodeLengthBucketNum = 10;
+
+	// Process-wide instance shared by the environment, characters and weapons
+	static FSCharacterTrainingStats& Get();
+
+	// Whether individual events should still be written to the log
+	static bool IsVerbose();
+
+	void RecordStep(const float Reward)
+	{
+		AgentSteps++;
+		RewardSum += Reward;
+	}
+
+	void RecordEpisodeEnd(const ESCharacterEpisodeEnd Reason, const int32 EpisodeSteps, const int32 MaxEpisodeSteps);
+
+	void RecordAgentReset() { AgentResets++; }
+	void RecordTargetReset() { TargetResets++; }
+	void RecordHealthReset() { HealthResets++; }
+	void RecordAmmoChange() { AmmoChanges++; }
+
+	void RecordStageTime(const ESCharacterTrainingStage Stage, const double Seconds)
+	{
+		StageSeconds[(int32)Stage] += Seconds;
+		StageCalls[(int32)Stage]++;
+	}
+
+	int64 GetAgentSteps() const { return AgentSteps; }
+
+	int32 GetStageCalls(const ESCharacterTrainingStage Stage) const { return StageCalls[(int32)Stage]; }
+
+	// One compact line with every counter and the episode length histogram
+	FString ToSummaryString() const;
+
+	void Reset();
+
+private:
+	int64 AgentSteps = 0;
+	double RewardSum = 0.0;
+	int32 AgentResets = 0;
+	int32 TargetResets = 0;
+	int32 HealthResets = 0;
+	int32 AmmoChanges = 0;
+	int32 EpisodeEnds[(int32)ESCharacterEpisodeEnd::Num] = {};
+	int64 EpisodeStepSum = 0;
+
+	// Wall time and call count per stage since the last summary
+	double StageSeconds[(int32)ESCharacterTrainingStage::Num] = {};
+	int32 StageCalls[(int32)ESCharacterTrainingStage::Num] = {};
+
+	// Episode lengths in tenths of the maximum episode length, the last bucket includes the maximum itself
+	int32 EpisodeLengthHistogram[EpisodeLengthBucketNum] = {};
+};
+
+/**
+ * Adds the lifetime of the scope to a stage of the shared training stats
+ */
+struct FSCharacterTrainingStageTimer
+{
+	explicit FSCharacterTrainingStageTimer(const ESCharacterTrainingStage InStage)
+		: Stage(InStage)
+		, StartSeconds(FPlatformTime::Seconds())
+	{
+	}
+
+	~FSCharacterTrainingStageTimer()
+	{
+		FSCharacterTrainingStats::Get().RecordStageTime(Stage, FPlatformTime::Seconds() - StartSeconds);
+	}
+
+private:
+	ESCharacterTrainingStage Stage;
+	double StartSeconds;
+};
@@ -56,7 +56,16 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Obstacle")
 	void InitializeObstacle(float Width, float Height, float Depth);
 
+	// Show and collide, or park the obstacle hidden and without collision while it waits in the pool
+	UFUNCTION(BlueprintCallable, Category = "Obstacle")
+	void SetObstacleActive(bool bActive);
+
+	UFUNCTION(BlueprintCallable, Category = "Obstacle")
+	bool IsObstacleActive() const { return bObstacleActive; }
+
 private:
+	bool bObstacleActive = true;
+
 	// Update collision box size based on obstacle dimensions
 	void UpdateCollisionBox();
 };
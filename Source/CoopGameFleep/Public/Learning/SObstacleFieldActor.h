@@ -0,0 +1,44 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "SObstacleFieldActor.generated.h"
+
+/**
+ * Every obstacle of a layout as one instance of a single instanced cube mesh
+ * Replaces one ASObstacleActor (root, mesh and collision box) per obstacle when training with dense layouts
+ */
+UCLASS()
+class COOPGAMEFLEEP_API ASObstacleFieldActor : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ASObstacleFieldActor();
+
+	// One instance and one collision body per obstacle, all owned by this component
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
+	UInstancedStaticMeshComponent* ObstacleInstances;
+
+	// Replace the layout, existing instances are moved in place and only the difference is added or removed
+	void SetObstacles(TArrayView<const FBox> Boxes);
+
+	UFUNCTION(BlueprintCallable, Category = "Obstacle")
+	int32 GetObstacleNum() const { return Centers.Num(); }
+
+	// Check if a location is blocked by any obstacle of the field, same test as ASObstacleActor::IsLocationBlocked
+	UFUNCTION(BlueprintCallable, Category = "Obstacle")
+	bool IsLocationBlocked(const FVector& Location, float AgentRadius = 50.0f) const;
+
+	// Get the bounds of one obstacle of the field
+	UFUNCTION(BlueprintCallable, Category = "Obstacle")
+	FBox GetObstacleBounds(int32 Index) const;
+
+private:
+	// Per-instance center and half size, the instance transforms are derived from these
+	TArray<FVector3f> Centers;
+	TArray<FVector3f> HalfExtents;
+};
@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Uniform XY grid over a set of obstacle boxes, stored in compressed rows: the boxes overlapping cell C are
+ * BoxIndices[CellStarts[C] .. CellStarts[C + 1]). Built once per layout change, queried for every agent step.
+ */
+struct COOPGAMEFLEEP_API FSObstacleGrid
+{
+	// Replace the indexed boxes, cell size is picked so a cell holds about one box
+	void Build(TArrayView<const FBox> InBoxes);
+
+	void Reset();
+
+	// Same result as testing every box expanded by Radius on all axes, like ASObstacleActor::IsLocationBlocked
+	bool IsLocationBlocked(const FVector& Location, const float Radius) const;
+
+	// IsLocationBlocked for every location at once, tests four boxes per instruction against the structure-of-arrays bounds
+	void AreLocationsBlocked(TArrayView<const FVector> Locations, const float Radius, TArrayView<bool> OutBlocked) const;
+
+	// Distance from Origin along each XY direction to the first box spanning Origin.Z, MaxDistance when none is that close
+	void TraceRays(const FVector& Origin, TArrayView<const FVector2f> Directions, const float MaxDistance, TArrayView<float> OutDistances) const;
+
+	int32 GetBoxNum() const { return Boxes.Num(); }
+
+	const FBox& GetBox(const int32 Index) const { return Boxes[Index]; }
+
+	TArrayView<const FBox> GetBoxes() const { return Boxes; }
+
+private:
+	FORCEINLINE int32 CellCoord(const double Value, const double Origin, const int32 CellNum) const
+	{
+		return FMath::Clamp((int32)((Value - Origin) * InvCellSize), 0, CellNum - 1);
+	}
+
+	TArray<FBox> Boxes;
+
+	// Box bounds as structure-of-arrays, padded to whole vector registers with boxes that contain nothing
+	TArray<float, TAlignedHeapAllocator<16>> BoxMinX;
+	TArray<float, TAlignedHeapAllocator<16>> BoxMinY;
+	TArray<float, TAlignedHeapAllocator<16>> BoxMinZ;
+	TArray<float, TAlignedHeapAllocator<16>> BoxMaxX;
+	TArray<float, TAlignedHeapAllocator<16>> BoxMaxY;
+	TArray<float, TAlignedHeapAllocator<16>> BoxMaxZ;
+
+	TArray<int32> CellStarts;
+	TArray<int32> BoxIndices;
+
+	// The same rows again as structure-of-arrays bounds, each cell's boxes copied out and padded to whole vector registers,
+	// so large layouts run the vector tests over a cell's boxes. Cell C covers CellBoxStarts[C] .. CellBoxStarts[C + 1]
+	TArray<int32> CellBoxStarts;
+	TArray<float, TAlignedHeapAllocator<16>> CellBoxMinX;
+	TArray<float, TAlignedHeapAllocator<16>> CellBoxMinY;
+	TArray<float, TAlignedHeapAllocator<16>> CellBoxMinZ;
+	TArray<float, TAlignedHeapAllocator<16>> CellBoxMaxX;
+	TArray<float, TAlignedHeapAllocator<16>> CellBoxMaxY;
+	TArray<float, TAlignedHeapAllocator<16>> CellBoxMaxZ;
+
+	// Union of all boxes, queries outside it return early
+	FBox Bounds = FBox(ForceInit);
+	double InvCellSize = 0.0;
+	int32 CellNumX = 0;
+	int32 CellNumY = 0;
+};
@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+// One obstacle of a stored layout, relative to the center of the placement region
+struct FSObstacleLayoutBox
+{
+	FVector2f Center;
+	FVector2f HalfSize;
+};
+
+// Fixed-size file header, followed by LayoutNum records of ObstaclesPerLayout boxes and SpawnPointsPerLayout points
+struct FSObstacleLayoutFileHeader
+{
+	static constexpr uint32 ExpectedMagic = 0x4C424F43; // "COBL"
+	static constexpr uint32 ExpectedVersion = 1;
+
+	uint32 Magic = ExpectedMagic;
+	uint32 Version = ExpectedVersion;
+	int32 LayoutNum = 0;
+	int32 ObstaclesPerLayout = 0;
+	int32 SpawnPointsPerLayout = 0;
+	int32 Seed = 0;
+	FVector2f RegionExtent = FVector2f::ZeroVector;
+	float AgentRadius = 0.0f;
+	uint32 Padding = 0;
+};
+
+// How a layout library is generated
+struct FSObstacleLayoutLibrarySettings
+{
+	int32 LayoutNum = 4096;
+	int32 ObstaclesPerLayout = 24;
+	int32 SpawnPointsPerLayout = 32;
+	int32 Seed = 1234;
+
+	// Half size of the placement region the layouts are generated for, should match the arenas they are used in
+	FVector2f RegionExtent = FVector2f(2000.0f, 2000.0f);
+
+	float MinObstacleSize = 60.0f;
+	float MaxObstacleSize = 120.0f;
+
+	// Spawn points keep at least this clearance from every obstacle
+	float AgentRadius = 50.0f;
+};
+
+/**
+ * Read-only corpus of pre-generated obstacle layouts, memory-mapped from a file written by USObstacleLayoutCommandlet.
+ * Every layout has the same stride, so fetching one by index is a pointer offset.
+ */
+class COOPGAMEFLEEP_API FSObstacleLayoutLibrary
+{
+public:
+	FSObstacleLayoutLibrary();
+	~FSObstacleLayoutLibrary();
+
+	// Generate every layout into a file, returns the number of candidate layouts rejected during validation or INDEX_NONE on failure
+	static int32 Generate(const FSObstacleLayoutLibrarySettings& Settings, const FString& Filename);
+
+	// Map a library file, replacing any previously opened one
+	bool Open(const FString& Filename);
+
+	void Close();
+
+	bool IsOpen() const { return Header != nullptr; }
+
+	const FSObstacleLayoutFileHeader& GetHeader() const { return *Header; }
+
+	int32 GetLayoutNum() const { return Header ? Header->LayoutNum : 0; }
+
+	TArrayView<const FSObstacleLayoutBox> GetObstacles(const int32 LayoutIndex) const;
+
+	// Free positions relative to the region center, clear of every obstacle of the layout by the agent radius
+	TArrayView<const FVector2f> GetSpawnPoints(const int32 LayoutIndex) const;
+
+private:
+	static int64 GetLayoutStride(const FSObstacleLayoutFileHeader& InHeader);
+
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	const FSObstacleLayoutFileHeader* Header = nullptr;
+	const uint8* Layouts = nullptr;
+};
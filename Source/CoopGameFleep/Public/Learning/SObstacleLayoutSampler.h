@@ -0,0 +1,22 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Blue-noise obstacle positions: dart throwing accelerated by a background grid holding at most one point per cell.
+ * When the region cannot fit the requested count at the current spacing, the spacing shrinks and sampling continues
+ * from the points already placed, so the result always has exactly the requested number of positions.
+ */
+struct COOPGAMEFLEEP_API FSObstacleLayoutSampler
+{
+	/**
+	 * Fill OutPositions with Count positions inside Region, none closer than ExclusionRadius to an exclusion center.
+	 * Returns the spacing every pair of positions respects, never more than needed to fit Count and never less than
+	 * MinSpacing unless the region is too crowded for it.
+	 */
+	static float Sample(const FBox2D& Region, const int32 Count, const float MinSpacing,
+		TArrayView<const FVector2D> ExclusionCenters, const float ExclusionRadius,
+		FRandomStream& Random, TArray<FVector2D>& OutPositions);
+};
@@ -6,9 +6,58 @@
 #include "Components/ActorComponent.h"
 #include "SObstacleActor.h"
 #include "Learning/ObstacleTypes.h"
+#include "Learning/SObstacleGrid.h"
 #include "GameFramework/Volume.h"
 #include "SObstacleManager.generated.h"
 
+class ASObstacleFieldActor;
+class FSObstacleLayoutLibrary;
+
+/**
+ * Snapshot of where obstacles are placed and how large they may be, taken from the LocationVolume or the fallback
+ * environment bounds so rejection sampling never walks the volume's components
+ */
+struct FSObstaclePlacementRegion
+{
+	FVector Origin = FVector::ZeroVector;
+	FVector Extent = FVector::ZeroVector;
+
+	// Vertical range of the ground trace and the height used when it hits nothing
+	float GroundTraceStartZ = 0.0f;
+	float GroundTraceEndZ = 0.0f;
+	float DefaultGroundZ = 0.0f;
+
+	// Ground Z traced on a regular grid from the region's minimum corner, empty when not cached
+	TArray<float> GroundHeights;
+	float GroundCellSize = 0.0f;
+	int32 GroundNumX = 0;
+	int32 GroundNumY = 0;
+
+	bool HasGroundHeights() const { return GroundHeights.Num() > 0; }
+
+	// Bilinear ground Z between the four surrounding samples
+	float GetGroundZ(const FVector& Position) const
+	{
+		const float GridX = FMath::Clamp((Position.X - (Origin.X - Extent.X)) / GroundCellSize, 0.0f, (float)(GroundNumX - 1));
+		const float GridY = FMath::Clamp((Position.Y - (Origin.Y - Extent.Y)) / GroundCellSize, 0.0f, (float)(GroundNumY - 1));
+		const int32 X0 = FMath::Clamp((int32)GridX, 0, FMath::Max(GroundNumX - 2, 0));
+		const int32 Y0 = FMath::Clamp((int32)GridY, 0, FMath::Max(GroundNumY - 2, 0));
+		const int32 X1 = FMath::Min(X0 + 1, GroundNumX - 1);
+		const int32 Y1 = FMath::Min(Y0 + 1, GroundNumY - 1);
+		const float AlphaX = GridX - X0;
+		const float AlphaY = GridY - Y0;
+
+		const float Z0 = FMath::Lerp(GroundHeights[Y0 * GroundNumX + X0], GroundHeights[Y0 * GroundNumX + X1], AlphaX);
+		const float Z1 = FMath::Lerp(GroundHeights[Y1 * GroundNumX + X0], GroundHeights[Y1 * GroundNumX + X1], AlphaX);
+		return FMath::Lerp(Z0, Z1, AlphaY);
+	}
+
+	bool ContainsXY(const FVector& Position) const
+	{
+		return Position.X >= Origin.X - Extent.X && Position.X <= Origin.X + Extent.X &&
+			Position.Y >= Origin.Y - Extent.Y && Position.Y <= Origin.Y + Extent.Y;
+	}
+};
 
 
 /**
@@ -46,6 +95,10 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Obstacle Configuration")
 	float MinDistanceFromAgents = 200.0f;
 
+	// Height of every obstacle, 0 to span the full height of the placement region
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Obstacle Configuration", meta = (ClampMin = "0.0"))
+	float ObstacleHeight = 0.0f;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Obstacle Configuration")
 	float MinDistanceFromTarget = 200.0f;
 
@@ -64,10 +117,34 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Obstacle Configuration")
 	TSubclassOf<ASObstacleActor> ObstacleClass = ASObstacleActor::StaticClass();
 
-	// Current obstacles
+	// Seeds obstacle positions and sizes, the same seed and calls give the same layouts
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Obstacle Configuration")
+	int32 RandomSeed = 1234;
+
+	// Trace the ground once on a grid over the placement region and interpolate it, instead of tracing every candidate position
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Obstacle Configuration")
+	bool bCacheGroundHeights = true;
+
+	// Spacing of the cached ground samples
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Obstacle Configuration", meta = (ClampMin = "1.0"))
+	float GroundCacheCellSize = 100.0f;
+
+	// Draw every obstacle as an instance of one ASObstacleFieldActor instead of one ASObstacleActor each
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Obstacle Configuration")
+	bool bUseInstancedObstacles = false;
+
+	// Current obstacle actors, empty when obstacles are instanced
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Obstacle Management")
 	TArray<ASObstacleActor*> CurrentObstacles;
 
+	// Holds the instanced obstacles, spawned on the first instanced layout
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Obstacle Management")
+	ASObstacleFieldActor* ObstacleField = nullptr;
+
+	// Every obstacle actor this manager has spawned, the first CurrentObstacles.Num() are in use and the rest are hidden
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Obstacle Management")
+	TArray<ASObstacleActor*> ObstaclePool;
+
 	// Initialize obstacles for the environment
 	UFUNCTION(BlueprintCallable, Category = "Obstacle Management")
 	void InitializeObstacles();
@@ -76,6 +153,13 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Obstacle Management")
 	void InitializeObstaclesWithSmartPlacement(const FVector& AgentLocation, const FVector& TargetLocation);
 
+	// Smart placement around any number of agents and targets, e.g. every agent of an arena resetting together
+	void InitializeObstaclesAroundLocations(TArrayView<const FVector> AvoidLocations);
+
+	// Resample only the obstacles centered inside Region, e.g. around the agents of a partial reset, keeping the rest of
+	// the layout and every obstacle near a protected location, e.g. an agent still mid-episode or its target
+	void RegenerateObstaclesInRegion(const FBox2D& Region, TArrayView<const FVector> AvoidLocations, TArrayView<const FVector> ProtectedLocations);
+
 	// Set the location volume for obstacle placement
 	UFUNCTION(BlueprintCallable, Category = "Obstacle Management")
 	void SetLocationVolume(AVolume* NewLocationVolume);
@@ -84,7 +168,7 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Obstacle Management")
 	void FindAndSetLocationVolume();
 
-	// Clear all obstacles
+	// Clear all obstacles, the actors are hidden and kept in the pool for the next layout
 	UFUNCTION(BlueprintCallable, Category = "Obstacle Management")
 	void ClearObstacles();
 
@@ -96,10 +180,55 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Obstacle Management")
 	bool IsLocationBlocked(const FVector& Location, float AgentRadius = 50.0f) const;
 
-	// Get all obstacles
+	// Blocked flag for each of a batch of locations, e.g. every agent of the arena in one reward pass
+	void AreLocationsBlocked(TArrayView<const FVector> Locations, float AgentRadius, TArrayView<bool> OutBlocked) const;
+
+	// Distance to the nearest obstacle along each XY direction from Origin, MaxDistance when nothing is that close
+	void TraceObstacleRays(const FVector& Origin, TArrayView<const FVector2f> Directions, float MaxDistance, TArrayView<float> OutDistances) const;
+
+	// Take layouts from a pre-generated library instead of sampling them, null to go back to sampling
+	void SetLayoutLibrary(TSharedPtr<const FSObstacleLayoutLibrary> InLayoutLibrary);
+
+	UFUNCTION(BlueprintCallable, Category = "Obstacle Management")
+	bool HasLayoutLibrary() const;
+
+	// Replace the layout with one from the library, a random one when the index is out of range
+	UFUNCTION(BlueprintCallable, Category = "Obstacle Management")
+	void ApplyLibraryLayout(int32 LayoutIndex = -1);
+
+	// Index of the library layout in use, INDEX_NONE when the layout was sampled
+	UFUNCTION(BlueprintCallable, Category = "Obstacle Management")
+	int32 GetCurrentLayoutIndex() const { return CurrentLayoutIndex; }
+
+	// Random precomputed free position of the current library layout that lies inside AllowedArea and is not one of TakenLocations
+	bool FindLibrarySpawnPoint(const FBox2D& AllowedArea, TArrayView<const FVector2D> TakenLocations, FVector2D& OutLocation);
+
+	// Restart the layout random stream from a new seed
+	UFUNCTION(BlueprintCallable, Category = "Obstacle Management")
+	void SetRandomSeed(int32 NewRandomSeed);
+
+	// Re-trace the cached ground heights, call after static geometry under the placement region changes
+	UFUNCTION(BlueprintCallable, Category = "Obstacle Management")
+	void RefreshGroundHeightCache();
+
+	// Re-read obstacle bounds into the spatial index, call after moving or resizing obstacles directly
+	UFUNCTION(BlueprintCallable, Category = "Obstacle Management")
+	void RebuildObstacleIndex();
+
+	// Get all obstacle actors
 	UFUNCTION(BlueprintCallable, Category = "Obstacle Management")
 	TArray<ASObstacleActor*> GetObstacles() const { return CurrentObstacles; }
 
+	// Number of obstacles in the current layout, whether they are actors or instances
+	UFUNCTION(BlueprintCallable, Category = "Obstacle Management")
+	int32 GetObstacleNum() const { return PlacedObstacleBounds.Num(); }
+
+	// Bounds of every obstacle in the current layout
+	TArrayView<const FBox> GetPlacedObstacleBounds() const { return PlacedObstacleBounds; }
+
+	// Height obstacles are placed with, 0 when neither ObstacleHeight nor the placement region gives them any
+	float GetObstacleHeight() const;
+
 	// Set obstacle mode
 	UFUNCTION(BlueprintCallable, Category = "Obstacle Management")
 	void SetObstacleMode(EObstacleMode NewMode);
@@ -111,16 +240,64 @@ public:
 private:
 	// Timer for shuffling obstacles in dynamic mode
 	float ShuffleTimer = 0.0f;
-	// Generate a random position for an obstacle
-	FVector GenerateRandomObstaclePosition(const FVector& AvoidLocation, float AvoidRadius) const;
 
-	// Check if a position is valid for obstacle placement
-	bool IsValidObstaclePosition(const FVector& Position, const FVector& AvoidLocation, float AvoidRadius) const;
+	// Bounds of the current layout, the actors or field instances are built from these
+	TArray<FBox> PlacedObstacleBounds;
 
-	// Create a single obstacle at the given position
-	ASObstacleActor* CreateObstacleAtPosition(const FVector& Position);
+	// Grid over the cached obstacle bounds, answers IsLocationBlocked without scanning every obstacle
+	FSObstacleGrid ObstacleIndex;
 
-	// Find ground level at a given position using line trace
+	// Next pool entry handed out by AcquirePooledObstacle
+	int32 NextPooledObstacle = 0;
+
+	// Return every obstacle to the pool without hiding it, so obstacles reused by the next layout never flicker
+	void ReleaseObstacles();
+
+	// Hide unused pool entries, push the layout to the instanced field and rebuild the spatial index
+	void CommitObstacleLayout();
+
+	// Hide the pool entries the current layout did not use
+	void HideUnusedObstacles();
+
+	// Next free pooled obstacle, spawning a new one only when the pool is exhausted
+	ASObstacleActor* AcquirePooledObstacle(const FVector& Position);
+
+	// Random stream for layouts, started from RandomSeed
+	FRandomStream LayoutRandom;
+
+	// Scratch positions of the layout being generated
+	TArray<FVector2D> LayoutPositions;
+
+	// Scratch of a regional regeneration, the obstacles kept and the centers new ones must stay clear of
+	TArray<FBox> KeptObstacleBounds;
+	TArray<FVector2D> RegionExclusionCenters;
+
+	// Shared memory-mapped layouts, set when running with a layout library
+	TSharedPtr<const FSObstacleLayoutLibrary> LayoutLibrary;
+	int32 CurrentLayoutIndex = INDEX_NONE;
+
+	// Replace the layout with exactly ObstacleCount well-spaced obstacles, none within AvoidRadius of an avoid location
+	void GenerateObstacleLayout(const int32 ObstacleCount, TArrayView<const FVector2D> AvoidLocations, const float AvoidRadius);
+
+	// Add a single obstacle of random size at the given position to the layout
+	bool PlaceObstacleAtPosition(const FVector& Position);
+
+	// Add a single obstacle of the given footprint at the given position to the layout
+	bool PlaceObstacle(const FVector& Position, const float WidthX, const float WidthY);
+
+	// Find ground level at a given position, from the ground cache when it covers the position
 	float FindGroundLevel(const FVector& Position) const;
+
+	// Find ground level at a given position using line trace
+	float TraceGroundLevel(const FVector& Position, const FSObstaclePlacementRegion& Region) const;
+
+	// Fill the region's ground height grid with one trace per sample
+	void SampleGroundHeights(FSObstaclePlacementRegion& Region) const;
+
+	// Placement region, captured on first use and again after the LocationVolume changes
+	const FSObstaclePlacementRegion& GetPlacementRegion() const;
+
+	mutable FSObstaclePlacementRegion PlacementRegion;
+	mutable bool bPlacementRegionValid = false;
 };
 
@@ -114,4 +114,12 @@ public:
 	UPROPERTY(BlueprintReadWrite, Category = "Learning")
 	bool bPlayerInputEnabled = true;
 
+	// Training-only pawn: no weapon, camera or actor tick. Set before BeginPlay to skip spawning them at all
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Learning")
+	bool bTrainingMode = false;
+
+	// Strip the pawn down to what movement needs, safe to call after BeginPlay
+	UFUNCTION(BlueprintCallable, Category = "Learning")
+	void EnableTrainingMode();
+
 };
@@ -0,0 +1,41 @@
+#include "Misc/AutomationTest.h"
+#include "Learning/SCharacterTrainingEnvironment.h"
+#include "Learning/SObstacleManager.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FArenaObstacleHeightTest, "CoopGameFleepTests.ArenaObstacleHeight", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FArenaObstacleHeightTest::RunTest(const FString &Parameters)
+{
+	// A tiled arena with the default flat reset bounds and no LocationVolume
+	USCharacterTrainingEnvironment* Environment = NewObject<USCharacterTrainingEnvironment>();
+	Environment->bUseInstancedObstacles = true;
+	Environment->ObstacleMode = EObstacleMode::Static;
+	TestEqual("reset bounds are flat", Environment->ResetBounds.Z, 0.0);
+
+	FSCharacterArena Arena;
+	Arena.Center = FVector(6000.0f, -2000.0f, 100.0f);
+	Arena.bIsPrimary = false;
+
+	USObstacleManager* Obstacles = Environment->GetOrCreateObstacleManager(Arena);
+	TestNotNull("arena gets an obstacle manager", Obstacles);
+	if (!Obstacles)
+	{
+		return false;
+	}
+
+	TestEqual("obstacles take the configured height", Obstacles->GetObstacleHeight(), Environment->ObstacleHeight);
+	TestTrue("static layout is placed", Obstacles->GetObstacleNum() > 0);
+
+	// A capsule standing on the ground at every obstacle's center is blocked, one far outside the arena is not
+	const float AgentHeight = Arena.Center.Z + 90.0f;
+	int32 Unblocked = 0;
+	for (const FBox& Bounds : Obstacles->GetPlacedObstacleBounds())
+	{
+		const FVector Center = Bounds.GetCenter();
+		Unblocked += Obstacles->IsLocationBlocked(FVector(Center.X, Center.Y, AgentHeight), 50.0f) ? 0 : 1;
+	}
+	TestEqual("every obstacle blocks at agent height", Unblocked, 0);
+	TestFalse("nothing blocks outside the arena", Obstacles->IsLocationBlocked(Arena.Center + FVector(0.0f, 10000.0f, 90.0f), 50.0f));
+
+	return true;
+}
@@ -0,0 +1,72 @@
+#include "Misc/AutomationTest.h"
+#include "Learning/SCharacterInteractor.h"
+#include "Learning/SCharacterTrainingEnvironment.h"
+#include "Learning/SObstacleManager.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInteractorScratchTest, "CoopGameFleepTests.InteractorScratch", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FInteractorScratchTest::RunTest(const FString &Parameters)
+{
+	// An instanced static layout needs no world, so the kernels can run against it directly
+	USCharacterTrainingEnvironment* Environment = NewObject<USCharacterTrainingEnvironment>();
+	Environment->bUseInstancedObstacles = true;
+	Environment->ObstacleMode = EObstacleMode::Static;
+
+	FSCharacterArena Arena;
+	Arena.Center = FVector(0.0f, 0.0f, 100.0f);
+	Arena.bIsPrimary = false;
+
+	const USObstacleManager* Obstacles = Environment->GetOrCreateObstacleManager(Arena);
+	TestNotNull("arena gets an obstacle manager", Obstacles);
+	if (!Obstacles)
+	{
+		return false;
+	}
+
+	// Past the old inline capacities of 64 rays and 256 cells
+	USCharacterInteractor* Interactor = NewObject<USCharacterInteractor>();
+	Interactor->ObstacleRayNum = 96;
+	Interactor->OccupancyGridSize = 32;
+	Interactor->ObservationHistoryLength = 4;
+	Interactor->ParallelGatherMinBatchSize = 4;
+
+	const int32 MaxAgentNum = 16;
+	Interactor->SpecifyObservationLayout(MaxAgentNum);
+	const SIZE_T AllocatedSize = Interactor->GetScratchAllocatedSize();
+
+	TArray<int32> AgentIds;
+	FSCharacterObservationBatch& Batch = Interactor->GetObservationBatch();
+	int32 RayHits = 0;
+
+	for (int32 Step = 0; Step < 8; Step++)
+	{
+		// Every other step only half the agents report, like partially completed episodes
+		const int32 AgentNum = Step % 2 == 0 ? MaxAgentNum : MaxAgentNum / 2;
+		AgentIds.Reset();
+		Batch.SetNum(AgentNum);
+		for (int32 Index = 0; Index < AgentNum; Index++)
+		{
+			const float Yaw = FMath::DegreesToRadians(Index * 22.5f + Step * 10.0f);
+			AgentIds.Add(Index);
+			Batch.Locations[Index] = Arena.Center + FVector(Index * 100.0f - 800.0f, Step * 50.0f, 90.0f);
+			Batch.Velocities[Index] = FVector(100.0f, 0.0f, 0.0f);
+			Batch.Forwards[Index] = FVector(FMath::Cos(Yaw), FMath::Sin(Yaw), 0.0f);
+			Batch.TargetLocations[Index] = Arena.Center + FVector(2000.0f, 0.0f, 90.0f);
+			Batch.ObstacleManagers[Index] = Obstacles;
+			Batch.bValid[Index] = true;
+		}
+
+		Interactor->ComputeObservationFeatures(AgentIds);
+
+		for (const float Distance : MakeArrayView(Batch.ObstacleRayDistances.GetData(), AgentNum * Interactor->ObstacleRayNum))
+		{
+			RayHits += Distance < 1.0f ? 1 : 0;
+		}
+	}
+
+	TestTrue("rays see the arena's obstacles", RayHits > 0);
+	TestEqual("no step grew the scratch buffers", Interactor->GetScratchBufferGrowthCount(), 0);
+	TestEqual("scratch allocation is unchanged across steps", (uint64)Interactor->GetScratchAllocatedSize(), (uint64)AllocatedSize);
+
+	return true;
+}
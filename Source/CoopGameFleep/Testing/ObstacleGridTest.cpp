@@ -0,0 +1,142 @@
+#include "Misc/AutomationTest.h"
+#include "Learning/SObstacleGrid.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FObstacleGridTest, "CoopGameFleepTests.ObstacleGrid", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FObstacleGridTest::RunTest(const FString &Parameters)
+{
+	FSObstacleGrid Grid;
+	TestFalse("empty grid blocks nothing", Grid.IsLocationBlocked(FVector::ZeroVector, 50.0f));
+
+	// Random layout of mixed sizes, including a few large boxes that span many cells
+	FRandomStream Random(1234);
+	TArray<FBox> Boxes;
+	for (int32 Index = 0; Index < 64; Index++)
+	{
+		const FVector Center(Random.FRandRange(-2000.0f, 2000.0f), Random.FRandRange(-2000.0f, 2000.0f), 50.0f);
+		const float Extent = Index % 16 == 0 ? 600.0f : Random.FRandRange(25.0f, 150.0f);
+		Boxes.Add(FBox::BuildAABB(Center, FVector(Extent, Random.FRandRange(25.0f, 150.0f), 50.0f)));
+	}
+	Grid.Build(Boxes);
+	TestEqual("grid keeps every box", Grid.GetBoxNum(), Boxes.Num());
+
+	// Every query must match a brute-force scan, inside and outside the layout bounds
+	int32 Mismatches = 0;
+	int32 Blocked = 0;
+	for (int32 Query = 0; Query < 4096; Query++)
+	{
+		const FVector Location(Random.FRandRange(-2600.0f, 2600.0f), Random.FRandRange(-2600.0f, 2600.0f), Random.FRandRange(-100.0f, 200.0f));
+		const float Radius = Random.FRandRange(0.0f, 100.0f);
+
+		bool bExpected = false;
+		for (const FBox& Box : Boxes)
+		{
+			bExpected |= Box.ExpandBy(Radius).IsInsideOrOn(Location);
+		}
+
+		Blocked += bExpected ? 1 : 0;
+		Mismatches += Grid.IsLocationBlocked(Location, Radius) != bExpected ? 1 : 0;
+	}
+	TestEqual("grid agrees with brute force", Mismatches, 0);
+	TestTrue("layout blocks some queries", Blocked > 0);
+
+	// Batched queries must match the single-location ones, including a count that is not a multiple of four boxes
+	TArray<FVector> Locations;
+	for (int32 Query = 0; Query < 1000; Query++)
+	{
+		Locations.Add(FVector(Random.FRandRange(-2600.0f, 2600.0f), Random.FRandRange(-2600.0f, 2600.0f), Random.FRandRange(-100.0f, 200.0f)));
+	}
+
+	TArray<bool> BatchBlocked;
+	BatchBlocked.SetNumUninitialized(Locations.Num());
+	for (const int32 BoxNum : { 64, 7 })
+	{
+		Grid.Build(MakeArrayView(Boxes.GetData(), BoxNum));
+		Grid.AreLocationsBlocked(Locations, 50.0f, BatchBlocked);
+
+		int32 BatchMismatches = 0;
+		for (int32 Query = 0; Query < Locations.Num(); Query++)
+		{
+			BatchMismatches += BatchBlocked[Query] != Grid.IsLocationBlocked(Locations[Query], 50.0f) ? 1 : 0;
+		}
+		TestEqual(FString::Printf(TEXT("batched query agrees with single queries over %d boxes"), BoxNum), BatchMismatches, 0);
+	}
+
+	// Past 256 boxes batched queries and rays go through the cells, they must still match single queries and every box on its own
+	TArray<FBox> DenseBoxes;
+	for (int32 Index = 0; Index < 400; Index++)
+	{
+		const FVector Center(Random.FRandRange(-2000.0f, 2000.0f), Random.FRandRange(-2000.0f, 2000.0f), 50.0f);
+		const float Extent = Index % 32 == 0 ? 400.0f : Random.FRandRange(10.0f, 60.0f);
+		DenseBoxes.Add(FBox::BuildAABB(Center, FVector(Extent, Random.FRandRange(10.0f, 60.0f), 50.0f)));
+	}
+	Grid.Build(DenseBoxes);
+	Grid.AreLocationsBlocked(Locations, 50.0f, BatchBlocked);
+
+	int32 DenseMismatches = 0;
+	for (int32 Query = 0; Query < Locations.Num(); Query++)
+	{
+		DenseMismatches += BatchBlocked[Query] != Grid.IsLocationBlocked(Locations[Query], 50.0f) ? 1 : 0;
+	}
+	TestEqual("batched query agrees with single queries over 400 boxes", DenseMismatches, 0);
+
+	TArray<FVector2f> FanDirections;
+	for (int32 Ray = 0; Ray < 24; Ray++)
+	{
+		const float Angle = FMath::DegreesToRadians(Ray * 15.0f);
+		FanDirections.Add(FVector2f(FMath::Cos(Angle), FMath::Sin(Angle)));
+	}
+
+	TArray<float> FanDistances;
+	TArray<float> SingleBoxDistances;
+	FanDistances.SetNumUninitialized(FanDirections.Num());
+	SingleBoxDistances.SetNumUninitialized(FanDirections.Num());
+	FSObstacleGrid SingleBoxGrid;
+	int32 RayMismatches = 0;
+	for (int32 Origin = 0; Origin < 16; Origin++)
+	{
+		const FVector FanOrigin(Random.FRandRange(-2000.0f, 2000.0f), Random.FRandRange(-2000.0f, 2000.0f), 50.0f);
+		Grid.TraceRays(FanOrigin, FanDirections, 800.0f, FanDistances);
+
+		TArray<float> Expected;
+		Expected.Init(800.0f, FanDirections.Num());
+		for (const FBox& Box : DenseBoxes)
+		{
+			SingleBoxGrid.Build(MakeArrayView(&Box, 1));
+			SingleBoxGrid.TraceRays(FanOrigin, FanDirections, 800.0f, SingleBoxDistances);
+			for (int32 Ray = 0; Ray < FanDirections.Num(); Ray++)
+			{
+				Expected[Ray] = FMath::Min(Expected[Ray], SingleBoxDistances[Ray]);
+			}
+		}
+
+		for (int32 Ray = 0; Ray < FanDirections.Num(); Ray++)
+		{
+			RayMismatches += FMath::IsNearlyEqual(FanDistances[Ray], Expected[Ray], 0.01f) ? 0 : 1;
+		}
+	}
+	TestEqual("rays over 400 boxes agree with every box on its own", RayMismatches, 0);
+
+	// Rays stop at the first face they hit, miss boxes outside their height and report the full length otherwise
+	const FBox Wall(FVector(100.0, -50.0, 0.0), FVector(150.0, 120.0, 200.0));
+	const FBox Beyond(FVector(300.0, -50.0, 0.0), FVector(350.0, 50.0, 200.0));
+	const FBox Low(FVector(-150.0, -50.0, 0.0), FVector(-100.0, 50.0, 20.0));
+	const FBox RayBoxes[] = { Wall, Beyond, Low };
+	Grid.Build(RayBoxes);
+
+	const FVector2f Directions[] = { FVector2f(1.0f, 0.0f), FVector2f(-1.0f, 0.0f), FVector2f(0.0f, 1.0f), FVector2f(UE_INV_SQRT_2, UE_INV_SQRT_2) };
+	float Distances[UE_ARRAY_COUNT(Directions)];
+	Grid.TraceRays(FVector(0.0, 0.0, 100.0), Directions, 1000.0f, Distances);
+	TestEqual("ray hits the nearest face", Distances[0], 100.0f, 0.01f);
+	TestEqual("ray passes under a low box", Distances[1], 1000.0f);
+	TestEqual("ray without obstacles reports its length", Distances[2], 1000.0f);
+	TestEqual("diagonal ray clips the wall corner", Distances[3], 100.0f * UE_SQRT_2, 0.01f);
+
+	Grid.TraceRays(FVector(125.0, 0.0, 100.0), Directions, 1000.0f, Distances);
+	TestEqual("ray starting inside a box reports zero", Distances[0], 0.0f);
+
+	Grid.Reset();
+	TestFalse("reset grid blocks nothing", Grid.IsLocationBlocked(Boxes[0].GetCenter(), 0.0f));
+
+	return true;
+}
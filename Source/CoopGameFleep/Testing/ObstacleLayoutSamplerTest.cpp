@@ -0,0 +1,52 @@
+#include "Misc/AutomationTest.h"
+#include "Learning/SObstacleLayoutSampler.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FObstacleLayoutSamplerTest, "CoopGameFleepTests.ObstacleLayoutSampler", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FObstacleLayoutSamplerTest::RunTest(const FString &Parameters)
+{
+	const FBox2D Region(FVector2D(-2000.0, -2000.0), FVector2D(2000.0, 2000.0));
+	const FVector2D Exclusions[] = { FVector2D(0.0, 0.0), FVector2D(1000.0, -500.0) };
+	const float ExclusionRadius = 150.0f;
+
+	FRandomStream RandomA(1234);
+	TArray<FVector2D> PositionsA;
+	const float Spacing = FSObstacleLayoutSampler::Sample(Region, 24, 60.0f, Exclusions, ExclusionRadius, RandomA, PositionsA);
+
+	TestEqual("exactly the requested count", PositionsA.Num(), 24);
+	TestTrue("spacing is at least the minimum", Spacing >= 60.0f);
+
+	bool bAllInside = true;
+	bool bAllClearOfExclusions = true;
+	double ClosestPair = UE_BIG_NUMBER;
+	for (int32 Index = 0; Index < PositionsA.Num(); Index++)
+	{
+		bAllInside &= Region.IsInsideOrOn(PositionsA[Index]);
+		for (const FVector2D& Exclusion : Exclusions)
+		{
+			bAllClearOfExclusions &= FVector2D::Distance(PositionsA[Index], Exclusion) >= ExclusionRadius;
+		}
+		for (int32 Other = Index + 1; Other < PositionsA.Num(); Other++)
+		{
+			ClosestPair = FMath::Min(ClosestPair, FVector2D::Distance(PositionsA[Index], PositionsA[Other]));
+		}
+	}
+	TestTrue("positions stay in the region", bAllInside);
+	TestTrue("positions avoid the exclusion radii", bAllClearOfExclusions);
+	TestTrue("no pair is closer than the reported spacing", ClosestPair >= Spacing);
+
+	// Same seed, same layout
+	FRandomStream RandomB(1234);
+	TArray<FVector2D> PositionsB;
+	FSObstacleLayoutSampler::Sample(Region, 24, 60.0f, Exclusions, ExclusionRadius, RandomB, PositionsB);
+	TestTrue("layout is deterministic from the seed", PositionsA == PositionsB);
+
+	// Far more obstacles than fit at the minimum spacing still yields the full count
+	FRandomStream RandomC(7);
+	TArray<FVector2D> Crowded;
+	const float CrowdedSpacing = FSObstacleLayoutSampler::Sample(FBox2D(FVector2D(0.0, 0.0), FVector2D(500.0, 500.0)), 200, 100.0f, {}, 0.0f, RandomC, Crowded);
+	TestEqual("crowded region still gets every obstacle", Crowded.Num(), 200);
+	TestTrue("crowded region relaxes the spacing", CrowdedSpacing < 100.0f);
+
+	return true;
+}
@@ -0,0 +1,66 @@
+#include "Misc/AutomationTest.h"
+#include "Learning/SCharacterPointMassSim.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPointMassSimTest, "CoopGameFleepTests.PointMassSim", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FPointMassSimTest::RunTest(const FString &Parameters)
+{
+	FSCharacterPointMassSimSettings Settings;
+	Settings.MaxObstacles = 1;
+
+	FSCharacterPointMassSim Sim;
+	Sim.Initialize(Settings, 2, 1234);
+
+	// Agent 0 walks straight at a target 1000 units ahead, agent 1 walks into a wall across its path
+	Sim.SetObstacle(0, 0, FBox2f(ForceInit));
+	Sim.SetObstacle(1, 0, FBox2f(FVector2f(200.0f, -500.0f), FVector2f(300.0f, 500.0f)));
+	Sim.SetAgentState(0, FVector2f(0.0f, 0.0f), 0.0f, FVector2f(1000.0f, 0.0f));
+	Sim.SetAgentState(1, FVector2f(0.0f, 0.0f), 0.0f, FVector2f(1000.0f, 0.0f));
+
+	float Rewards[2];
+	bool Completed[2] = { false, false };
+	int32 ReachedStep = INDEX_NONE;
+	float ReachReward = 0.0f;
+
+	for (int32 Step = 0; Step < 240 && ReachedStep == INDEX_NONE; Step++)
+	{
+		Sim.SetAction(0, 1.0f, 0.0f, 0.0f);
+		Sim.SetAction(1, 1.0f, 0.0f, 0.0f);
+		Sim.Step(1.0f / 60.0f);
+		Sim.Evaluate(MakeArrayView(Rewards), MakeArrayView(Completed));
+
+		if (Completed[0])
+		{
+			ReachedStep = Step;
+			ReachReward = Rewards[0];
+		}
+	}
+
+	// Accelerating to 600 units/s covers the 850 units to the reach radius in well under 4 seconds
+	TestTrue("agent reaches an unobstructed target", ReachedStep != INDEX_NONE);
+	TestTrue("reaching pays the reach reward", ReachReward >= Settings.Rewards.ReachTargetReward + Settings.Rewards.TimeStepPenalty - UE_KINDA_SMALL_NUMBER);
+	TestTrue("speed never exceeds the walking limit", Sim.GetVelocity(1).Size() <= Settings.MaxSpeed + UE_KINDA_SMALL_NUMBER);
+	TestTrue("wall stops the agent before it overlaps", Sim.GetLocation(1).X <= 200.0f - Settings.CapsuleRadius);
+	TestTrue("agent against the wall is blocked", Sim.IsAgentBlocked(1));
+
+	// Turning in place rotates the facing without moving
+	Sim.SetAgentState(0, FVector2f(0.0f, 0.0f), 0.0f, FVector2f(1000.0f, 0.0f));
+	for (int32 Step = 0; Step < 18; Step++)
+	{
+		Sim.SetAction(0, 0.0f, 0.0f, 1.0f);
+		Sim.Step(1.0f / 60.0f);
+	}
+	TestTrue("full turn input yaws by TurnDegreesPerStep", Sim.GetForward(0).Equals(FVector(0.0f, 1.0f, 0.0f), 0.01f));
+	TestTrue("turning in place does not move", Sim.GetLocation(0).Equals(FVector(0.0f, 0.0f, Sim.GetLocation(0).Z)));
+
+	// Resets are reproducible from the seed
+	FSCharacterPointMassSim SimA;
+	FSCharacterPointMassSim SimB;
+	SimA.Initialize(Settings, 4, 42);
+	SimB.Initialize(Settings, 4, 42);
+	TestTrue("same seed gives the same episode", SimA.GetTargetLocation(3).Equals(SimB.GetTargetLocation(3)) && SimA.GetLocation(3).Equals(SimB.GetLocation(3)));
+	TestTrue("target starts at least the minimum distance away",
+		FVector::Dist(SimA.GetLocation(3), SimA.GetTargetLocation(3)) >= Settings.MinDistanceBetweenCharacterAndTarget);
+
+	return true;
+}
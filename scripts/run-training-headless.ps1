@@ -19,15 +19,23 @@ param(
     [float]$DiscountFactor = 0.99,
     [float]$GaeLambda = 0.95,
     [float]$ActionEntropyWeight = 0.0,
+    [int]$DecisionInterval = 1,     # Simulation steps each policy decision is held for
     [int]$TimeoutMinutes = 0,       # 0 or negative => run indefinitely
     [switch]$KillTreeOnTimeout = $true,
     [string]$TrainingTaskName = "",
+    [int]$NumAgents = 0,            # 0 => only use agents placed in the map
+    [int]$NumArenas = 1,            # Independent arena tiles, agents assigned round-robin
+    [string]$PerAgentTargets = "false",  # Give every agent its own target instead of sharing its arena's
     # Obstacle configuration parameters
     [string]$UseObstacles = "true",
     [int]$MaxObstacles = 8,
     [float]$MinObstacleSize = 100.0,
     [float]$MaxObstacleSize = 300.0,
-    [string]$ObstacleMode = "Static"  # "Static" or "Dynamic"
+    [string]$ObstacleMode = "Static",  # "Static" or "Dynamic"
+    # Simulation stepping parameters
+    [string]$SimulationMode = "RealTime",  # "RealTime", "FastForward" or "PointMass"
+    [int]$SimStepsPerFrame = 1,
+    [float]$SimDeltaTime = 0.016667
 )
 
 # Helper to sanitize task names for filesystem and CLI usage
@@ -131,6 +139,7 @@ Write-Host "  Number of Iterations: $NumberOfIterations" -ForegroundColor White
 Write-Host "  Discount Factor: $DiscountFactor" -ForegroundColor White
 Write-Host "  GAE Lambda: $GaeLambda" -ForegroundColor White
 Write-Host "  Action Entropy Weight: $ActionEntropyWeight" -ForegroundColor White
+Write-Host "  Decision Interval: $DecisionInterval" -ForegroundColor White
 Write-Host ""
 Write-Host "Obstacle Configuration:" -ForegroundColor Cyan
 Write-Host "  Use Obstacles: $UseObstaclesBool" -ForegroundColor White
@@ -214,11 +223,18 @@ $GameArgs = @(
     "-DiscountFactor=$DiscountFactor"  # Reward discount factor
     "-GaeLambda=$GaeLambda"  # GAE lambda parameter
     "-ActionEntropyWeight=$ActionEntropyWeight"  # Action entropy weight
+    "-DecisionInterval=$DecisionInterval"  # Simulation steps per policy decision
+    "-NumAgents=$NumAgents"  # Total agents to spawn in this process
+    "-NumArenas=$NumArenas"  # Independent arena tiles
+    "-PerAgentTargets=$PerAgentTargets"  # One target per agent instead of per arena
     "-UseObstacles=$UseObstaclesBool"  # Enable/disable obstacles
     "-MaxObstacles=$MaxObstacles"  # Maximum number of obstacles
     "-MinObstacleSize=$MinObstacleSize"  # Minimum obstacle size
     "-MaxObstacleSize=$MaxObstacleSize"  # Maximum obstacle size
     "-ObstacleMode=$ObstacleMode"  # Obstacle mode (Static/Dynamic)
+    "-SimulationMode=$SimulationMode"  # Simulation stepping (RealTime/FastForward/PointMass)
+    "-SimStepsPerFrame=$SimStepsPerFrame"  # Training steps per frame (FastForward/PointMass)
+    "-SimDeltaTime=$SimDeltaTime"  # Simulated seconds per step
 )
 
 if ($TrainerTaskName) {